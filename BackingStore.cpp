@@ -0,0 +1,168 @@
+#include "BackingStore.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+BackingStore::BackingStore(const std::string& directory, size_t initialSlots) {
+	std::filesystem::create_directories(directory);
+	filePath = directory + "/swap.bin";
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+		CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	fileHandle = file == INVALID_HANDLE_VALUE ? nullptr : file;
+	if (fileHandle == nullptr) {
+		std::cerr << "Error: Unable to create backing store file " << filePath << std::endl;
+		return;
+	}
+#else
+	fileDescriptor = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fileDescriptor == -1) {
+		std::cerr << "Error: Unable to create backing store file " << filePath << std::endl;
+		return;
+	}
+#endif
+
+	map(std::max<size_t>(initialSlots, 1));
+}
+
+BackingStore::~BackingStore() {
+	unmap();
+#ifdef _WIN32
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+	}
+#else
+	if (fileDescriptor != -1) {
+		close(fileDescriptor);
+	}
+#endif
+}
+
+bool BackingStore::map(size_t newSlotCount) {
+	// The new view is mapped before the old one is released, so a failed grow leaves
+	// every stored record reachable through the current mapping
+	size_t bytes = newSlotCount * sizeof(SwapRecord);
+
+#ifdef _WIN32
+	if (fileHandle == nullptr) {
+		return false;
+	}
+	// Creating a mapping larger than the file extends it
+	HANDLE newMapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<unsigned long long>(bytes) >> 32), static_cast<DWORD>(bytes), nullptr);
+	if (newMapping == nullptr) {
+		return false;
+	}
+	void* view = MapViewOfFile(newMapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+	if (view == nullptr) {
+		CloseHandle(newMapping);
+		return false;
+	}
+#else
+	if (fileDescriptor == -1 || ftruncate(fileDescriptor, static_cast<off_t>(bytes)) != 0) {
+		return false;
+	}
+	void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+#endif
+
+	unmap();
+#ifdef _WIN32
+	mappingHandle = newMapping;
+#endif
+	slots = static_cast<SwapRecord*>(view);
+
+	// New slots go on the free stack so the lowest numbers are used first
+	for (size_t slot = newSlotCount; slot > slotCount; slot--) {
+		freeSlots.push_back(slot - 1);
+	}
+	slotCount = newSlotCount;
+	return true;
+}
+
+void BackingStore::unmap() {
+	if (slots == nullptr) {
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(slots);
+	CloseHandle(mappingHandle);
+	mappingHandle = nullptr;
+#else
+	munmap(slots, slotCount * sizeof(SwapRecord));
+#endif
+	slots = nullptr;
+}
+
+bool BackingStore::store(const SwapRecord& record) {
+	size_t slot;
+	size_t* existing = slotIndex.find(static_cast<int>(record.processId));
+	if (existing != nullptr) {
+		slot = *existing;
+	}
+	else {
+		// Out of slots, double the file
+		if (freeSlots.empty() && !map(std::max<size_t>(slotCount * 2, 1))) {
+			std::cerr << "Error: Unable to grow backing store file " << filePath << std::endl;
+			return false;
+		}
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		slotIndex[static_cast<int>(record.processId)] = slot;
+	}
+
+	std::memcpy(&slots[slot], &record, sizeof(SwapRecord));
+	slots[slot].inUse = 1;
+	return true;
+}
+
+void BackingStore::discard(uint32_t processId) {
+	size_t* slot = slotIndex.find(static_cast<int>(processId));
+	if (slot != nullptr) {
+		slots[*slot].inUse = 0;
+		freeSlots.push_back(*slot);
+		slotIndex.erase(static_cast<int>(processId));
+	}
+}
+
+void BackingStore::flush() {
+	if (slots == nullptr) {
+		return;
+	}
+#ifdef _WIN32
+	FlushViewOfFile(slots, 0);
+#else
+	msync(slots, slotCount * sizeof(SwapRecord), MS_ASYNC);
+#endif
+}
+
+bool BackingStore::take(uint32_t processId, SwapRecord& record) {
+	size_t* found = slotIndex.find(static_cast<int>(processId));
+	if (found == nullptr) {
+		return false;
+	}
+
+	size_t slot = *found;
+	std::memcpy(&record, &slots[slot], sizeof(SwapRecord));
+	slots[slot].inUse = 0;
+	slotIndex.erase(static_cast<int>(processId));
+	freeSlots.push_back(slot);
+	return record.inUse != 0 && record.processId == processId;
+}
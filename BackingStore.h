@@ -0,0 +1,57 @@
+#ifndef BACKINGSTORE_H
+#define BACKINGSTORE_H
+
+#include <cstdint>
+#include <string>
+#include "PidMap.h"
+#include <vector>
+
+// Swap file for processes evicted from memory.
+// A single preallocated file is mapped into the address space and divided into
+// fixed-size binary slots, one per swapped process. Slots are found through an
+// in-memory index keyed by process ID, so swapping is a memcpy into the mapping
+// instead of a file open/write/close. Records hold process state only, never
+// pointer values, so a record stays valid however the process object moves.
+class BackingStore {
+public:
+	struct SwapRecord {
+		uint32_t processId;
+		uint32_t commandIndex;
+		uint32_t totalCommands;
+		uint32_t memorySize;
+		uint32_t numPages;
+		uint32_t inUse;  // Nonzero while the slot holds a swapped process
+	};
+
+	BackingStore(const std::string& directory, size_t initialSlots = 1024);
+	~BackingStore();
+
+	BackingStore(const BackingStore&) = delete;
+	BackingStore& operator=(const BackingStore&) = delete;
+
+	bool store(const SwapRecord& record);                 // Writes or overwrites the process's slot
+	bool take(uint32_t processId, SwapRecord& record);    // Reads and frees the process's slot
+	void discard(uint32_t processId);                     // Frees the slot without reading it
+	void flush();                                         // Schedules written slots for writeback to disk
+	bool contains(uint32_t processId) const { return slotIndex.contains(static_cast<int>(processId)); }
+	size_t size() const { return slotIndex.size(); }
+
+private:
+	std::string filePath;
+	size_t slotCount = 0;
+	SwapRecord* slots = nullptr;  // Start of the mapped file
+	PidMap<size_t> slotIndex;  // Process ID to slot
+	std::vector<size_t> freeSlots;  // Stack of unused slots
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;     // HANDLE, kept opaque so callers don't pull in windows.h
+	void* mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+
+	bool map(size_t newSlotCount);  // (Re)sizes the file and maps it
+	void unmap();
+};
+
+#endif // BACKINGSTORE_H
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <iterator>
 #include <cstdlib>
 #include "ConsoleManager.h"
 
@@ -9,13 +11,103 @@ using namespace std;
 
 static ConsoleManager* consoleManager;
 
-int main() {
+// Splits a batch script into commands; ';' and newlines separate them, '#' starts a comment
+static vector<string> parseScript(const string& script) {
+    vector<string> commands;
+    string command;
+    bool inComment = false;
+    for (char c : script + "\n") {
+        if (c == ';' || c == '\n' || c == '\r') {
+            size_t first = command.find_first_not_of(" \t");
+            if (first != string::npos) {
+                commands.push_back(command.substr(first, command.find_last_not_of(" \t") - first + 1));
+            }
+            command.clear();
+            inComment = false;
+        }
+        else if (c == '#') {
+            inComment = true;
+        }
+        else if (!inComment) {
+            command += c;
+        }
+    }
+    return commands;
+}
+
+static void printUsage() {
+    cerr << "Usage: CSOPESY_Emulator [--batch \"cmd; cmd; ...\" | --script <file>] [--results <file>]" << endl;
+}
+
+// Runs the commands without a prompt and finishes with a JSON summary of the run
+static int runBatch(const vector<string>& commands, const string& resultsPath) {
+    consoleManager->setHeadless(true);
+    for (const string& command : commands) {
+        cout << "root:\\> " << command << endl;
+        if (!consoleManager->handleCommand(command)) {
+            break;
+        }
+    }
+
+    // Every thread is joined before the results are read, so the counters are final
+    consoleManager->shutdown();
+    int status = consoleManager->getFailedCommands() > 0 ? 1 : 0;
+    if (resultsPath.empty()) {
+        consoleManager->writeResults(cout);
+        return status;
+    }
+    ofstream resultsFile(resultsPath);
+    if (!resultsFile.is_open()) {
+        cerr << "Cannot write results to " << resultsPath << endl;
+        return 1;
+    }
+    consoleManager->writeResults(resultsFile);
+    return status;
+}
+
+int main(int argc, char* argv[]) {
     int cpuCycles = 0;
     string input;
     bool running = true;
     consoleManager = new ConsoleManager();
+
+    // Headless batch mode: --batch "<commands>" or --script <file>, optionally --results <file>
+    string script, resultsPath;
+    bool batch = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--batch" || arg == "--script" || arg == "--results") && i + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        if (arg == "--batch") {
+            script += string(argv[++i]) + "\n";
+            batch = true;
+        }
+        else if (arg == "--script") {
+            ifstream scriptFile(argv[++i]);
+            if (!scriptFile.is_open()) {
+                cerr << "Cannot open script " << argv[i] << endl;
+                return 1;
+            }
+            script.append(istreambuf_iterator<char>(scriptFile), istreambuf_iterator<char>());
+            script += "\n";
+            batch = true;
+        }
+        else if (arg == "--results") {
+            resultsPath = argv[++i];
+        }
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (batch) {
+        return runBatch(parseScript(script), resultsPath);
+    }
+
     consoleManager->printHeader();  // Display the initial header
-    
+
     while (running) {
         // If in a session, show the session name in the prompt
         if (consoleManager->isInSession()) {
@@ -25,12 +117,15 @@ int main() {
             cout << "root:\\> ";
         }
 
-        // Get the user input
-        getline(cin, input);
+        // Get the user input; end of input behaves like exit
+        if (!getline(cin, input)) {
+            break;
+        }
 
         // Handle the command and check if the application should keep running
         running = consoleManager->handleCommand(input);
     }
 
+    consoleManager->shutdown();
     return 0;
 }
@@ -7,10 +7,12 @@
 #include <vector>
 #include <algorithm>
 
-ConfigManager::ConfigManager()
+ConfigManager::ConfigManager(const string& path)
 {
+	configPath = path;
 	numCpu = 0;
 	schedulerType = SchedulerType::FCFS;
+	executionMode = ExecutionMode::REALTIME;
 	quantumCycles = 0;
 	batchProcessFreq = 0;
 	minIns = 0;
@@ -20,6 +22,11 @@ ConfigManager::ConfigManager()
 	memPerFrame = 0;
 	minMemPerProcess = 0;
 	maxMemPerProcess = 0;
+	fitPolicy = FitPolicy::FIRST_FIT;
+	allocatorType = AllocatorType::FLAT;
+	replacementPolicy = ReplacementPolicy::FIFO;
+	mlfqLevels = 4;
+	mlfqBoostTicks = 1000;
 	readConfig();
 }
 
@@ -28,13 +35,14 @@ ConfigManager::~ConfigManager()
 }
 
 void ConfigManager::readConfig() {
-    std::ifstream file("config.txt");
+    std::ifstream file(configPath);
     std::string line;
 
     if (!file.is_open()) {
-        cout << RED << "> Error: Could not open the file 'config.txt'." << RESET << endl;
+        cout << RED << "> Error: Could not open the file '" << configPath << "'." << RESET << endl;
         return;
     }
+    bool allocatorTypeSet = false;
     while (std::getline(file, line)) {
         if (line.find("num-cpu") == 0) {
             numCpu = stoi(line.substr(8));  // Parse num-cpu value
@@ -53,6 +61,30 @@ void ConfigManager::readConfig() {
             else if (typeString == "'rr'") {
                 schedulerType = SchedulerType::RR;
             }
+            else if (typeString == "\"rr-ws\"" || typeString == "'rr-ws'") {
+                schedulerType = SchedulerType::RR_WS;
+            }
+            else if (typeString == "\"sjf\"" || typeString == "'sjf'") {
+                schedulerType = SchedulerType::SJF;
+            }
+            else if (typeString == "\"srtf\"" || typeString == "'srtf'") {
+                schedulerType = SchedulerType::SRTF;
+            }
+            else if (typeString == "\"mlfq\"" || typeString == "'mlfq'") {
+                schedulerType = SchedulerType::MLFQ;
+            }
+            else if (typeString == "\"cfs\"" || typeString == "'cfs'") {
+                schedulerType = SchedulerType::CFS;
+            }
+        }
+        else if (line.find("mode") == 0) {
+            std::string modeString = line.substr(5);  // Parse mode value
+            if (modeString == "\"simulate\"" || modeString == "'simulate'") {
+                executionMode = ExecutionMode::SIMULATE;
+            }
+            else if (modeString == "\"realtime\"" || modeString == "'realtime'") {
+                executionMode = ExecutionMode::REALTIME;
+            }
         }
         else if (line.find("quantum-cycles") == 0) {
             quantumCycles = stoi(line.substr(15));  // Parse quantum-cycles value
@@ -81,11 +113,68 @@ void ConfigManager::readConfig() {
         else if (line.find("max-mem-per-proc") == 0) {
           maxMemPerProcess = stoi(line.substr(17));  // Parse mem-per-process value
         }
+        else if (line.find("mem-allocator") == 0) {
+            std::string allocatorString = line.substr(14);  // Parse mem-allocator value
+            allocatorTypeSet = true;
+            if (allocatorString == "\"flat\"" || allocatorString == "'flat'") {
+                allocatorType = AllocatorType::FLAT;
+            }
+            else if (allocatorString == "\"paging\"" || allocatorString == "'paging'") {
+                allocatorType = AllocatorType::PAGING;
+            }
+            else if (allocatorString == "\"buddy\"" || allocatorString == "'buddy'") {
+                allocatorType = AllocatorType::BUDDY;
+            }
+            else {
+                allocatorTypeSet = false;
+            }
+        }
+        else if (line.find("page-replacement") == 0) {
+            std::string policyString = line.substr(17);  // Parse page-replacement value
+            if (policyString == "\"fifo\"" || policyString == "'fifo'") {
+                replacementPolicy = ReplacementPolicy::FIFO;
+            }
+            else if (policyString == "\"lru\"" || policyString == "'lru'") {
+                replacementPolicy = ReplacementPolicy::LRU;
+            }
+            else if (policyString == "\"clock\"" || policyString == "'clock'") {
+                replacementPolicy = ReplacementPolicy::CLOCK;
+            }
+        }
+        else if (line.find("mlfq-levels") == 0) {
+            mlfqLevels = std::clamp(stoi(line.substr(12)), 1, 16);  // Parse mlfq-levels value
+        }
+        else if (line.find("mlfq-boost-ticks") == 0) {
+            mlfqBoostTicks = max(stoi(line.substr(17)), 1);  // Parse mlfq-boost-ticks value
+        }
+        else if (line.find("mem-fit") == 0) {
+            std::string fitString = line.substr(8);  // Parse mem-fit value
+            if (fitString == "\"first-fit\"" || fitString == "'first-fit'") {
+                fitPolicy = FitPolicy::FIRST_FIT;
+            }
+            else if (fitString == "\"best-fit\"" || fitString == "'best-fit'") {
+                fitPolicy = FitPolicy::BEST_FIT;
+            }
+            else if (fitString == "\"next-fit\"" || fitString == "'next-fit'") {
+                fitPolicy = FitPolicy::NEXT_FIT;
+            }
+        }
 
     }
 
     file.close();
 
+    // Without an explicit mem-allocator, a single frame spanning all memory means flat allocation
+    if (!allocatorTypeSet) {
+        allocatorType = memPerFrame == maxOverallMem ? AllocatorType::FLAT : AllocatorType::PAGING;
+    }
+
+    // The simulator has a single central ready queue, so per-core queues and stealing have nothing to model
+    if (executionMode == ExecutionMode::SIMULATE && schedulerType == SchedulerType::RR_WS) {
+        cout << YELLOW << "> Warning: 'rr-ws' is not simulated; running 'rr' instead." << RESET << endl;
+        schedulerType = SchedulerType::RR;
+    }
+
 	 // displayConfig();
 }
 
@@ -99,10 +188,26 @@ void ConfigManager::displayConfig() {
         case SchedulerType::RR:
             std::cout << "RR" << std::endl;
             break;
+        case SchedulerType::RR_WS:
+            std::cout << "RR (work stealing)" << std::endl;
+            break;
+        case SchedulerType::SJF:
+            std::cout << "SJF" << std::endl;
+            break;
+        case SchedulerType::SRTF:
+            std::cout << "SRTF" << std::endl;
+            break;
+        case SchedulerType::MLFQ:
+            std::cout << "MLFQ (" << mlfqLevels << " levels, boost every " << mlfqBoostTicks << " ticks)" << std::endl;
+            break;
+        case SchedulerType::CFS:
+            std::cout << "CFS" << std::endl;
+            break;
         default:
             std::cout << "Unknown" << std::endl;
             break;
         }
+	std::cout << "Execution mode: " << (executionMode == ExecutionMode::SIMULATE ? "Simulate" : "Realtime") << std::endl;
 	std::cout << "Quantum cycles: " << quantumCycles << std::endl;
 	std::cout << "Batch process frequency: " << batchProcessFreq << std::endl;
 	std::cout << "Minimum instructions: " << minIns << std::endl;
@@ -112,4 +217,40 @@ void ConfigManager::displayConfig() {
 	std::cout << "Memory per frame: " << memPerFrame << std::endl;
 	std::cout << "Min Memory per process: " << minMemPerProcess << std::endl;
 	std::cout << "Max Memory per process: " << maxMemPerProcess << std::endl;
+	std::cout << "Memory allocator: ";
+	switch (allocatorType) {
+		case AllocatorType::FLAT:
+			std::cout << "Flat" << std::endl;
+			break;
+		case AllocatorType::PAGING:
+			std::cout << "Paging" << std::endl;
+			break;
+		case AllocatorType::BUDDY:
+			std::cout << "Buddy" << std::endl;
+			break;
+	}
+	std::cout << "Page replacement policy: ";
+	switch (replacementPolicy) {
+		case ReplacementPolicy::FIFO:
+			std::cout << "FIFO" << std::endl;
+			break;
+		case ReplacementPolicy::LRU:
+			std::cout << "LRU" << std::endl;
+			break;
+		case ReplacementPolicy::CLOCK:
+			std::cout << "CLOCK" << std::endl;
+			break;
+	}
+	std::cout << "Flat memory fit policy: ";
+	switch (fitPolicy) {
+		case FitPolicy::FIRST_FIT:
+			std::cout << "First fit" << std::endl;
+			break;
+		case FitPolicy::BEST_FIT:
+			std::cout << "Best fit" << std::endl;
+			break;
+		case FitPolicy::NEXT_FIT:
+			std::cout << "Next fit" << std::endl;
+			break;
+	}
 }
\ No newline at end of file
@@ -8,9 +8,13 @@ using namespace std;
 class ConfigManager
 {
 public:
-	enum SchedulerType { FCFS, RR };  // Scheduler types: First-Come-First-Serve, Round-Robin
+	enum SchedulerType { FCFS, RR, RR_WS, SJF, SRTF, MLFQ, CFS };  // Scheduler types: First-Come-First-Serve, Round-Robin, Round-Robin with work stealing, Shortest-Job-First, Shortest-Remaining-Time-First, Multilevel Feedback Queue, Completely Fair Scheduler
+	enum ExecutionMode { REALTIME, SIMULATE };  // Wall-clock threads, or a virtual-time discrete-event simulation
+	enum FitPolicy { FIRST_FIT, BEST_FIT, NEXT_FIT };  // Free-run selection for flat memory allocation
+	enum AllocatorType { FLAT, PAGING, BUDDY };  // Memory allocation strategies
+	enum ReplacementPolicy { FIFO, LRU, CLOCK };  // Victim selection for demand paging
 
-	ConfigManager();
+	ConfigManager(const string& path = "config.txt");  // Benchmarks point this at generated configs
 	~ConfigManager();
 
 	void readConfig();
@@ -18,6 +22,7 @@ public:
 
 	int getNumCpu() { return numCpu; };
 	SchedulerType getSchedulerType() { return schedulerType; };
+	ExecutionMode getExecutionMode() { return executionMode; };
 	int getQuantumCycles() { return quantumCycles; };
 	int getBatchProcessFreq() { return batchProcessFreq; };
 	int getMinIns() { return minIns; };
@@ -27,10 +32,17 @@ public:
 	int getMemPerFrame() { return memPerFrame; };
 	int getMinMemPerProcess() { return minMemPerProcess; };
 	int getMaxMemPerProcess() { return maxMemPerProcess; };
+	FitPolicy getFitPolicy() { return fitPolicy; };
+	AllocatorType getAllocatorType() { return allocatorType; };
+	ReplacementPolicy getReplacementPolicy() { return replacementPolicy; };
+	int getMlfqLevels() { return mlfqLevels; };
+	int getMlfqBoostTicks() { return mlfqBoostTicks; };
 
 private:
+	string configPath;
 	int numCpu;
 	SchedulerType schedulerType;
+	ExecutionMode executionMode;
 	int quantumCycles;
 	int batchProcessFreq;
 	int minIns;
@@ -40,5 +52,10 @@ private:
 	int memPerFrame;
 	int minMemPerProcess;
 	int maxMemPerProcess;
+	FitPolicy fitPolicy;
+	AllocatorType allocatorType;
+	ReplacementPolicy replacementPolicy;
+	int mlfqLevels;      // MLFQ priority levels; level n gets quantum-cycles << n
+	int mlfqBoostTicks;  // MLFQ: ticks between moving every process back to the top level
 };
 #endif // CONFIGMANAGER_H
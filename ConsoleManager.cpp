@@ -3,12 +3,13 @@
 #include <thread>
 #include <iomanip>
 #include <fstream>
-#include <format>
 #include <string>
 #include <map>
 #include <memory>
 #include <mutex>
 #include "Colors.h"
+#include "PidMap.h"
+#include "Timestamp.h"
 
 using namespace std;
 
@@ -16,17 +17,21 @@ ConsoleManager::ConsoleManager() {
 }
 
 ConsoleManager::~ConsoleManager() {
-    for (auto& process : processes) {
-        delete process.second;
-    }
 }
 
-bool ConsoleManager::createProcess(const std::string& name) {
+bool ConsoleManager::createProcess(const std::string& name, int nice) {
     lock_guard<mutex> lock(processMutex);
 
     if (processes.find(name) == processes.end()) {
-        Process* process = new Process(name, configManager->getMinIns(), configManager->getMaxIns(), configManager->getMinMemPerProcess(), configManager->getMaxMemPerProcess(), configManager->getMemPerFrame());
+        ProcessHandle process = processPool.create(name, configManager->getMinIns(), configManager->getMaxIns(), configManager->getMinMemPerProcess(), configManager->getMaxMemPerProcess(), configManager->getMemPerFrame());
+        Process* created = processPool.get(process);  // Empty handle when every pool slot is taken
+        if (created == nullptr) {
+            cout << RED << "> Error: Process pool full; 'reap' frees finished processes." << RESET << endl;
+            return false;
+        }
+        created->setNice(nice);  // Before the scheduler can see it
         processes[name] = process;
+        publishedProcesses.load()->append(process);
         scheduler->addProcess(process);  // Add process to scheduler
         return true;
     }
@@ -40,7 +45,6 @@ bool ConsoleManager::reattachProcess(const std::string& name) {
     lock_guard<mutex> lock(processMutex);
 
     if (processes.find(name) != processes.end()) {
-        Process* process = processes[name];
         return true;
     }
     else {
@@ -49,8 +53,22 @@ bool ConsoleManager::reattachProcess(const std::string& name) {
     }
 }
 
+std::shared_ptr<ProcessList> ConsoleManager::collectSnapshots(std::vector<ProcessSnapshot>& snapshots) {
+    // Callers keep the returned list alive while they read the processes; reaping waits for it
+    std::shared_ptr<ProcessList> list = publishedProcesses.load();
+    snapshots.reserve(list->size());
+    list->forEach([&](ProcessHandle handle) {
+        Process* process = processPool.get(handle);
+        if (process != nullptr) {
+            snapshots.push_back({ process, process->snapshot() });
+        }
+    });
+    return list;
+}
+
 void ConsoleManager::listProcess() {
-    lock_guard<mutex> lock(processMutex);
+    std::vector<ProcessSnapshot> snapshots;
+    std::shared_ptr<ProcessList> list = collectSnapshots(snapshots);
 
     bool hasRunning = false, hasFinished = false;
 
@@ -59,12 +77,11 @@ void ConsoleManager::listProcess() {
     // Display running processes
     cout << "---------------------------------------" << endl;
     cout << "Running processes:" << endl;
-    for (const auto& pair : processes) {
-        if (pair.second->getStatus() == Process::RUNNING) {
+    for (const ProcessSnapshot& snapshot : snapshots) {
+        if (snapshot.state.status == Process::RUNNING) {
             hasRunning = true;
-            cout << format("{:>8}   {}   Core: {}   {} / {}\n",
-                pair.first, pair.second->getRunTimestamp(), pair.second->getCoreIndex(),
-                pair.second->getCommandIndex() + 1, pair.second->getTotalCommands());
+            cout << setw(8) << snapshot.process->getProcessName() << "   " << Timestamp::format(snapshot.state.runTime) << "   Core: " << snapshot.state.coreIndex
+                << "   " << snapshot.state.commandIndex + 1 << " / " << snapshot.process->getTotalCommands() << "\n";
         }
     }
     if (!hasRunning) {
@@ -74,38 +91,201 @@ void ConsoleManager::listProcess() {
     // Display finished processes
     cout << endl;
     cout << "Finished processes:" << endl;
-    for (const auto& pair : processes) {
-        if (pair.second->getStatus() == Process::FINISHED) {
+    for (const ProcessSnapshot& snapshot : snapshots) {
+        if (snapshot.state.status == Process::FINISHED) {
             hasFinished = true;
-            cout << format("{:>8}   {}   Finished   {} / {}\n",
-                pair.first, pair.second->getRunTimestamp(),
-                pair.second->getCommandIndex()+1, pair.second->getTotalCommands());
+            cout << setw(8) << snapshot.process->getProcessName() << "   " << Timestamp::format(snapshot.state.runTime) << "   Finished"
+                << "   " << snapshot.state.commandIndex+1 << " / " << snapshot.process->getTotalCommands() << "\n";
         }
     }
     if (!hasFinished) {
         cout << "   No finished processes." << endl;
     }
+
+    size_t footprint = 0;
+    for (const ProcessSnapshot& snapshot : snapshots) {
+        footprint += snapshot.process->getMemoryFootprint();
+    }
+    cout << endl;
+    cout << "Process memory: " << footprint / 1024 << " KB for " << snapshots.size() << " processes";
+    if (!snapshots.empty()) {
+        cout << " (" << footprint / snapshots.size() << " bytes each)";
+    }
+    cout << endl;
     cout << "---------------------------------------" << endl << endl;
 }
 
+void ConsoleManager::reapProcesses() {
+    // Only processes the scheduler has retired are reaped; their pool slots are reused
+    std::vector<ProcessHandle> finished = scheduler->takeFinishedProcesses();
+
+    lock_guard<mutex> lock(processMutex);
+    PidMap<bool> reaped;
+    for (ProcessHandle handle : finished) {
+        Process* process = processPool.get(handle);
+        if (process != nullptr) {
+            processes.erase(process->getProcessName());
+            reaped[process->getProcessId()] = true;
+        }
+    }
+
+    // Publish the surviving processes, then wait out readers still walking the old list
+    std::shared_ptr<ProcessList> compacted = std::make_shared<ProcessList>();
+    std::shared_ptr<ProcessList> old = publishedProcesses.load();
+    old->forEach([&](ProcessHandle handle) {
+        Process* process = processPool.get(handle);
+        if (process != nullptr && !reaped.contains(process->getProcessId())) {
+            compacted->append(handle);
+        }
+    });
+    publishedProcesses.store(compacted);
+    while (old.use_count() > 1) {
+        std::this_thread::yield();
+    }
+
+    reapedCount += reaped.size();
+    for (ProcessHandle handle : finished) {
+        processPool.release(handle);
+    }
+    cout << GREEN << "> Reaped " << finished.size() << " finished processes (" << processPool.size() << " of "
+        << processPool.capacity() << " pool slots in use)." << RESET << endl;
+}
+
 void ConsoleManager::schedulerTest() {
-    std::thread([this]{
+    if (scheduler->isSimulating()) {
+        // Processes are generated in virtual time as the clock is advanced
         schedulerTestRun = true;
-        
-        int cpuCycles = 1;
-		    int i = 1;
+        nextGenerationTick = scheduler->getSimulatedTick() + configManager->getBatchProcessFreq() - 1;
+        return;
+    }
+
+    if (testThread.joinable()) {
+        if (schedulerTestRun) {
+            return;  // Already generating
+        }
+        testThread.join();  // Exits within a tick of scheduler-stop
+    }
+    schedulerTestRun = true;
+    testThread = std::thread([this]{
+        // Generate on the shared CPU clock so batch-process-freq is measured in the same ticks as execution
+        CpuClock* cpuClock = scheduler->getCpuClock();
+        int batchProcessFreq = max(configManager->getBatchProcessFreq(), 1);
+        unsigned long long lastTick = cpuClock->getTick();
+        unsigned long long cpuCycles = 0;
 
         while (schedulerTestRun) {
-            if (cpuCycles % configManager->getBatchProcessFreq() == 0) {
-                string processName = "process" + to_string(i);
-                createProcess(processName);
-                i++;
+            unsigned long long tick = cpuClock->awaitTick(lastTick);
+
+            // Catch up on any ticks that passed while a process was being created
+            for (; lastTick < tick; lastTick++) {
+                cpuCycles++;
+                if (cpuCycles % batchProcessFreq == 0 && schedulerTestRun) {
+                    string processName = "process" + to_string(testProcessCounter);
+                    createProcess(processName);
+                    testProcessCounter++;
+                }
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            cpuCycles++;
         }
-     }).detach();
-    
+     });
+}
+
+void ConsoleManager::shutdown() {
+    if (!initialized) {
+        return;
+    }
+    // The generator waits on the CPU clock, so it has to finish before the scheduler stops the clock
+    schedulerTestRun = false;
+    if (testThread.joinable()) {
+        testThread.join();
+    }
+    scheduler->stop();
+    memoryAllocator->stop();
+}
+
+void ConsoleManager::advanceSimulation(unsigned long long ticks) {
+    unsigned long long targetTick = scheduler->getSimulatedTick() + ticks;
+    unsigned long long batchProcessFreq = max(configManager->getBatchProcessFreq(), 1);
+
+    // Step from one process generation to the next, letting the scheduler run the events in between
+    while (schedulerTestRun && nextGenerationTick <= targetTick) {
+        scheduler->advanceTo(nextGenerationTick);
+        createProcess("process" + to_string(testProcessCounter));
+        testProcessCounter++;
+        nextGenerationTick += batchProcessFreq;
+    }
+    scheduler->advanceTo(targetTick);
+}
+
+void ConsoleManager::waitTicks(unsigned long long ticks) {
+    if (scheduler->isSimulating()) {
+        advanceSimulation(ticks);
+        return;
+    }
+    CpuClock* cpuClock = scheduler->getCpuClock();
+    unsigned long long targetTick = cpuClock->getTick() + ticks;
+    unsigned long long tick = cpuClock->getTick();
+    while (tick < targetTick) {
+        tick = cpuClock->awaitTick(tick);
+    }
+}
+
+void ConsoleManager::writeResults(std::ostream& out) {
+    if (!initialized) {
+        out << "{\"initialized\":false}" << endl;
+        return;
+    }
+
+    std::vector<ProcessSnapshot> snapshots;
+    std::shared_ptr<ProcessList> list = collectSnapshots(snapshots);
+    unsigned long long finished = reapedCount, running = 0;
+    for (const ProcessSnapshot& snapshot : snapshots) {
+        if (snapshot.state.status == Process::FINISHED) {
+            finished++;
+        }
+        else if (snapshot.state.status == Process::RUNNING) {
+            running++;
+        }
+    }
+
+    const char* schedulerName = "fcfs";
+    switch (configManager->getSchedulerType()) {
+        case ConfigManager::SchedulerType::FCFS: schedulerName = "fcfs"; break;
+        case ConfigManager::SchedulerType::RR: schedulerName = "rr"; break;
+        case ConfigManager::SchedulerType::RR_WS: schedulerName = "rr-ws"; break;
+        case ConfigManager::SchedulerType::SJF: schedulerName = "sjf"; break;
+        case ConfigManager::SchedulerType::SRTF: schedulerName = "srtf"; break;
+        case ConfigManager::SchedulerType::MLFQ: schedulerName = "mlfq"; break;
+        case ConfigManager::SchedulerType::CFS: schedulerName = "cfs"; break;
+    }
+
+    unsigned long long ticks = scheduler->isSimulating() ? scheduler->getSimulatedTick() : scheduler->getCpuClock()->getTick();
+    CpuStats cpu = scheduler->getCpuStats();
+    MemoryAllocator::MemoryStats memory = memoryAllocator->getMemoryStats();
+    double totalTicks = static_cast<double>(cpu.activeTicks + cpu.idleTicks);
+
+    std::ios_base::fmtflags flags = out.flags();
+    out << fixed << setprecision(3)
+        << "{\"mode\":\"" << (scheduler->isSimulating() ? "simulate" : "realtime") << "\""
+        << ",\"scheduler\":\"" << schedulerName << "\""
+        << ",\"numCpu\":" << configManager->getNumCpu()
+        << ",\"ticks\":" << ticks
+        << ",\"wallSeconds\":" << (Timestamp::now() - startTime) / 1e9
+        << ",\"processesCreated\":" << snapshots.size() + reapedCount
+        << ",\"processesFinished\":" << finished
+        << ",\"processesRunning\":" << running
+        << ",\"finishedPerKiloTick\":" << (ticks > 0 ? finished * 1000.0 / ticks : 0.0)
+        << ",\"activeTicks\":" << cpu.activeTicks
+        << ",\"idleTicks\":" << cpu.idleTicks
+        << ",\"cpuUtilization\":" << (totalTicks > 0 ? cpu.activeTicks / totalTicks : 0.0)
+        << ",\"dispatches\":" << cpu.dispatches
+        << ",\"preemptions\":" << cpu.preemptions
+        << ",\"swapWaitTicks\":" << cpu.swapWaitTicks
+        << ",\"pagesIn\":" << memory.pagesIn
+        << ",\"pagesOut\":" << memory.pagesOut
+        << ",\"pageFaults\":" << memory.pageFaults
+        << ",\"swapWriteBatches\":" << memory.swapWriteBatches
+        << "}" << endl;
+    out.flags(flags);
 }
 
 void ConsoleManager::reportUtil() {
@@ -114,7 +294,9 @@ void ConsoleManager::reportUtil() {
     ofstream outFile(fileName, ios::out | ios::trunc);  // Open the file for writing and trunc if not empty
 
     if (outFile.is_open()){
-        if (processes.empty()) {
+        std::vector<ProcessSnapshot> snapshots;
+        std::shared_ptr<ProcessList> list = collectSnapshots(snapshots);
+        if (snapshots.empty()) {
             outFile << "> No processes available." << endl;
             return;
         }
@@ -131,12 +313,11 @@ void ConsoleManager::reportUtil() {
         // Display queued processes
         outFile << "---------------------------------------" << endl;
         outFile << "Running processes:" << endl;
-        for (const auto& pair : processes) {
-            if (pair.second->getStatus() == Process::RUNNING) {
+        for (const ProcessSnapshot& snapshot : snapshots) {
+            if (snapshot.state.status == Process::RUNNING) {
                 hasRunning = true;
-                outFile << format("{:>8}   {}   Core: {}   {} / {}\n",
-                    pair.first, pair.second->getRunTimestamp(), pair.second->getCoreIndex(),
-                    pair.second->getCommandIndex() + 1, pair.second->getTotalCommands());
+                outFile << setw(8) << snapshot.process->getProcessName() << "   " << Timestamp::format(snapshot.state.runTime) << "   Core: " << snapshot.state.coreIndex
+                    << "   " << snapshot.state.commandIndex + 1 << " / " << snapshot.process->getTotalCommands() << "\n";
             }
         }
         if (!hasRunning) {
@@ -146,12 +327,11 @@ void ConsoleManager::reportUtil() {
         // Display finished processes
         outFile << endl;
         outFile << "Finished processes:" << endl;
-        for (const auto& pair : processes) {
-            if (pair.second->getStatus() == Process::FINISHED) {
+        for (const ProcessSnapshot& snapshot : snapshots) {
+            if (snapshot.state.status == Process::FINISHED) {
                 hasFinished = true;
-                outFile << format("{:>8}   {}   Finished   {} / {}\n",
-                    pair.first, pair.second->getRunTimestamp(),
-                    pair.second->getCommandIndex() + 1, pair.second->getTotalCommands());
+                outFile << setw(8) << snapshot.process->getProcessName() << "   " << Timestamp::format(snapshot.state.runTime) << "   Finished"
+                    << "   " << snapshot.state.commandIndex + 1 << " / " << snapshot.process->getTotalCommands() << "\n";
             }
         }
         if (!hasFinished) {
@@ -167,8 +347,9 @@ void ConsoleManager::reportUtil() {
 
 void ConsoleManager::initialize(){
 	configManager = new ConfigManager();
-  memoryAllocator = new MemoryAllocator(configManager);
-	scheduler = new Scheduler(configManager, memoryAllocator);
+	tracer = new Tracer(configManager->getNumCpu());
+  memoryAllocator = new MemoryAllocator(configManager, tracer);
+	scheduler = new Scheduler(configManager, memoryAllocator, &processPool, tracer);
 	initialized = true;
 }
 
@@ -179,12 +360,21 @@ bool ConsoleManager::handleCommand(const string& command) {
             cout << "> Exiting session..." << endl;
             inSession = false;  // Mark as no longer in a session
             currentSessionName = "";
-            system("cls");  // Clear the screen when returning to the main menu
+            clearScreen();  // Clear the screen when returning to the main menu
             printHeader();  // Re-display the main menu header
             return true;
         }
         else if (command == "process-smi") {
-           processes[currentSessionName]->processSMI();
+           lock_guard<mutex> lock(processMutex);  // Reaping erases sessions
+           auto session = processes.find(currentSessionName);
+           Process* process = session != processes.end() ? processPool.get(session->second) : nullptr;
+           if (process != nullptr) {
+               process->processSMI();
+           }
+           else {
+               failedCommands++;
+               cout << RED << "> Error: Process " << currentSessionName << " no longer exists." << RESET << endl;
+           }
         }
     }
 
@@ -198,10 +388,11 @@ bool ConsoleManager::handleCommand(const string& command) {
             else if (command == "exit") {
                 // Exit the emulator
                 cout << "> Exiting emulator..." << endl;
-                exit(0);
+                return false;
             }
             else {
                 // Unrecognized command before initialization
+                failedCommands++;
                 cout << RED << "> Error: System is not initialized. Please type 'initialize'." << RESET << endl;
             }
         }
@@ -220,19 +411,43 @@ bool ConsoleManager::handleCommand(const string& command) {
                 // if input was screen -s <blank>
                 if (command.length() <= 10 || command.substr(10).find_first_not_of(' ') == string::npos) {
                     // If there's no input after "screen -s" or it's just whitespace
+                    failedCommands++;
                     cout << RED << "> Error: Missing process name for 'screen -s' command." << RESET << endl;
                 }
                 else {
-                    // Create a new screen session with the given name
+                    // Create a new screen session with the given name and an optional nice value: "screen -s <name> [-n <nice>]"
                     string processName = command.substr(10);
-                    bool res = createProcess(processName);  // Create a session
+                    int nice = 0;
+                    bool valid = true;
+                    size_t flag = (" " + processName + " ").rfind(" -n ");
+                    if (flag != string::npos) {
+                        string niceString = flag + 3 < processName.size() ? processName.substr(flag + 3) : "";
+                        processName = flag > 0 ? processName.substr(0, flag - 1) : "";
+                        size_t digits = !niceString.empty() && niceString[0] == '-' ? 1 : 0;
+                        valid = niceString.size() > digits && niceString.size() <= digits + 2
+                            && niceString.find_first_not_of("0123456789", digits) == string::npos;
+                        if (valid) {
+                            nice = stoi(niceString);
+                            valid = nice >= -20 && nice <= 19;
+                        }
+                        if (!valid) {
+                            failedCommands++;
+                            cout << RED << "> Error: Nice value must be an integer from -20 to 19." << RESET << endl;
+                        }
+                        else if (processName.find_first_not_of(' ') == string::npos) {
+                            failedCommands++;
+                            cout << RED << "> Error: Missing process name for 'screen -s' command." << RESET << endl;
+                            valid = false;
+                        }
+                    }
+                    bool res = valid && createProcess(processName, nice);  // Create a session
                     if (res) {
-                        system("cls");
+                        clearScreen();
                         inSession = true;  // Mark that the user is now in a session
                         currentSessionName = processName; 
                     }
-                    else {
-                        cout << YELLOW << "> Error: Process already exists." << RESET << endl;
+                    else if (valid) {
+                        failedCommands++;
                     }
                 }
             }
@@ -241,20 +456,24 @@ bool ConsoleManager::handleCommand(const string& command) {
 
                 if (command.length() <= 10 || command.substr(10).find_first_not_of(' ') == string::npos) {
                     // If there's no input after "screen -r" or it's just whitespace
+                    failedCommands++;
                     cout << RED << "> Error: Missing process name for 'screen -r' command." << RESET << endl;
                 }
                 else {
                     string processName = command.substr(10);
                     if (reattachProcess(processName)) {
-                        system("cls");
+                        clearScreen();
                         inSession = true;  // Mark that the user is now in a session
                         currentSessionName = processName;  // Set the active session name
                     }
+                    else {
+                        failedCommands++;
+                    }
                 }
             }
             else if (command == "screen -ls") {
                 // List all active sessions
-                system("cls");
+                clearScreen();
                 
                 printHeader();
                 cout << "root:\\> screen -ls" << endl;
@@ -270,26 +489,85 @@ bool ConsoleManager::handleCommand(const string& command) {
                 cout << GREEN << "> Stopping creation of dummy processes" << RESET << endl;
                 schedulerTestStop();
             }
+            else if (command.substr(0, 7) == "advance") {
+                // Advance the virtual clock in simulate mode
+                string ticks = command.length() > 8 ? command.substr(8) : "";
+                if (!scheduler->isSimulating()) {
+                    failedCommands++;
+                    cout << RED << "> Error: 'advance' is only available when mode is \"simulate\"." << RESET << endl;
+                }
+                else if (ticks.empty() || ticks.find_first_not_of("0123456789") != string::npos) {
+                    failedCommands++;
+                    cout << RED << "> Error: Usage is 'advance <ticks>'." << RESET << endl;
+                }
+                else {
+                    advanceSimulation(stoull(ticks));
+                    cout << GREEN << "> Simulated clock at tick " << scheduler->getSimulatedTick() << "." << RESET << endl;
+                }
+            }
+            else if (command == "wait" || command.substr(0, 5) == "wait ") {
+                // Let the emulator run for a number of CPU ticks: "wait <n>" or "wait <n> ticks"
+                string ticks = command.length() > 5 ? command.substr(5) : "";
+                if (ticks.size() > 6 && ticks.substr(ticks.size() - 6) == " ticks") {
+                    ticks = ticks.substr(0, ticks.size() - 6);
+                }
+                if (ticks.empty() || ticks.find_first_not_of("0123456789") != string::npos) {
+                    failedCommands++;
+                    cout << RED << "> Error: Usage is 'wait <ticks> [ticks]'." << RESET << endl;
+                }
+                else {
+                    waitTicks(stoull(ticks));
+                }
+            }
+            else if (command == "reap") {
+                // Free finished processes so their slots can be reused
+                reapProcesses();
+            }
+            else if (command == "trace on") {
+                tracer->enable();
+                cout << GREEN << "> Tracing scheduling events." << RESET << endl;
+            }
+            else if (command == "trace off") {
+                tracer->disable();
+                cout << GREEN << "> Tracing stopped." << RESET << endl;
+            }
+            else if (command.substr(0, 10) == "trace-dump") {
+                // Write the recorded events as Chrome trace-event JSON
+                string fileName = command.length() > 11 ? command.substr(11) : "trace.json";
+                size_t written = tracer->dump(fileName);
+                if (written == 0) {
+                    failedCommands++;
+                    cout << RED << "> No trace events written to " << fileName << ". Run 'trace on' first, or check the path." << RESET << endl;
+                }
+                else {
+                    cout << GREEN << "> Wrote " << written << " trace events to " << fileName << "." << RESET << endl;
+                }
+            }
             else if (command == "report-util") {
                 // Handle report-util command
                 reportUtil();
             }
             else if (command == "clear") {
                 // Clear the screen and print the header again
-                system("cls");
+                clearScreen();
                 printHeader();
             }
             else if (command == "help") {
                 // Display the list of available commands
                 cout << LIGHT_YELLOW << "> List of commands:" << endl
                     << "    - initialize            (initializes processor configuration and scheduler based on config.txt)" << endl
-                    << "    - screen -s <name>      (start a new process)" << endl
+                    << "    - screen -s <name> [-n <nice>] (start a new process; nice -20..19 weights it under cfs)" << endl
                     << "    - screen -r <name>      (reattaches to an existing process)" << endl
                     << "    - screen -ls            (list all processes)" << endl
                     << "    - process-smi           (prints process info, only applicable when attached to a process)" << endl
                     << "    - scheduler-test        (starts the creation of dummy processes at configured intervals)" << endl
                     << "    - scheduler-stop        (stops the creation of dummy processes initiated by scheduler-test)" << endl
                     << "    - report-util           (generates a CPU utilization report and writes it to csopesy-log.txt)" << endl
+                    << "    - advance <ticks>       (advances the virtual clock, only in simulate mode)" << endl
+                    << "    - wait <ticks> [ticks]  (lets the CPU clock run for the given number of ticks)" << endl
+                    << "    - reap                  (frees finished processes and removes them from screen -ls)" << endl
+                    << "    - trace on / trace off  (starts or stops recording scheduling events)" << endl
+                    << "    - trace-dump [file]     (writes recorded events as Chrome trace JSON, default trace.json)" << endl
                     << "    - clear                 (clears the screen)" << endl
                   << "    - process-smi                (prints memory utilization and running processes with memory)" << endl
 									<< "    - vmstat                (prints CPU utilization and memory stats)" << endl
@@ -299,35 +577,49 @@ bool ConsoleManager::handleCommand(const string& command) {
             else if (command == "exit") {
                 // Exit the emulator
                 cout << "> Exiting emulator..." << endl;
-                exit(0);
+                return false;
             }
             else if (command == "process-smi") {
-              system("cls");
+              clearScreen();
               printHeader();
               cout << "root:\\> process-smi" << endl;
-              memoryAllocator->showProcessSMI(scheduler->getCpuUtilization().utilization);
+              memoryAllocator->showProcessSMI(scheduler->getCpuUtilization().utilization, scheduler->getCpuStats());
             }
             else if (command == "vmstat") {
-              system("cls");
+              clearScreen();
               printHeader();
               cout << "root:\\> vmstat" << endl;
-							memoryAllocator->showVmStat(scheduler->idleCpuTicks, scheduler->activeCpuTicks);
+							memoryAllocator->showVmStat(scheduler->getCpuStats());
 						}
             else {
                 // Handle unrecognized command
+                failedCommands++;
                 cout << "> Unrecognized command: " << command << endl;
             }
         }
     }
     else {
         // If the user is in a session and tries an invalid command
+        if (command != "process-smi") {
+            failedCommands++;
+        }
         cout << "> You are in a process session. Use 'exit' to leave." << endl;
     }
 
     return true;
 }
 
+void ConsoleManager::clearScreen() {
+    // ANSI clear and home, the same escape support the colors rely on; batch runs keep their log intact
+    if (!headless) {
+        cout << "\033[2J\033[H" << flush;
+    }
+}
+
 void ConsoleManager::printHeader() {
+    if (headless) {
+        return;
+    }
     cout << GREEN << "   _   _  _ ___ __  __ " << WHITE << " ___  ___  " << endl
         << GREEN << "  /_\\ | \\| |_ _|  \\/  |" << WHITE << "/ _ \\/ __| " << endl
         << GREEN << " / _ \\| .` || || |\\/| |" << WHITE << " (_) \\__ \\ " << endl
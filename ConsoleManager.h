@@ -6,23 +6,52 @@
 #include <vector>
 #include <queue>
 #include <mutex>
+#include <thread>
 #include "Process.h"
 #include "Scheduler.h"
 #include "ConfigManager.h"
+#include "ProcessPool.h"
+#include "ProcessList.h"
+#include "Tracer.h"
+#include "Timestamp.h"
+#include <atomic>
+#include <memory>
+#include <ostream>
 
 class ConsoleManager {
 private:
-    std::map<std::string, Process*> processes;
+    std::map<std::string, ProcessHandle> processes;
+    ProcessPool processPool;  // Owns every process; the map and scheduler hold handles
+
+    // Monitoring commands walk this list instead of the map, without taking processMutex.
+    // Reaping publishes a compacted copy and waits for readers of the old one to finish.
+    std::atomic<std::shared_ptr<ProcessList>> publishedProcesses{ std::make_shared<ProcessList>() };
+
+    struct ProcessSnapshot {
+        Process* process;
+        Process::Snapshot state;
+    };
+    std::shared_ptr<ProcessList> collectSnapshots(std::vector<ProcessSnapshot>& snapshots);
 
 	ConfigManager* configManager;
     Scheduler* scheduler;
 		MemoryAllocator* memoryAllocator;
+    Tracer* tracer;  // Scheduling event recorder, toggled with 'trace on' / 'trace off'
 
 	string currentSessionName;
     bool inSession = false;
     bool initialized = false;
 
-    bool schedulerTestRun = false;
+    bool headless = false;  // Batch mode: no screen clearing or banners
+    unsigned long long reapedCount = 0;  // Finished processes freed by reap, still counted in results
+    long long startTime = Timestamp::now();
+
+    std::atomic<bool> schedulerTestRun{ false };
+    std::thread testThread;  // Realtime mode: generates dummy processes on the CPU clock
+    int testProcessCounter = 1;  // Suffix for the next dummy process name
+    unsigned long long nextGenerationTick = 0;  // Simulate mode: virtual tick of the next dummy process
+
+    unsigned int failedCommands = 0;  // Commands that printed an error; batch mode exits non-zero if any did
 
     std::mutex processMutex;
 
@@ -31,15 +60,23 @@ public:
     ~ConsoleManager();
 
 	void printHeader();
+	void clearScreen();
+	void setHeadless(bool enabled) { headless = enabled; }
 
-    bool createProcess(const std::string& name);
+    bool createProcess(const std::string& name, int nice = 0);
 
     bool reattachProcess(const std::string& name);
 
     void listProcess();
+    void reapProcesses();
 
     void schedulerTest();
     void schedulerTestStop() { schedulerTestRun = false; };
+    void advanceSimulation(unsigned long long ticks);
+    void waitTicks(unsigned long long ticks);  // Advances virtual time, or blocks on the CPU clock in realtime mode
+    void writeResults(std::ostream& out);      // One-line JSON summary for batch runs
+    void shutdown();                           // Stops and joins every emulator thread; results stay readable
+    unsigned int getFailedCommands() const { return failedCommands; }
 
     void reportUtil();
 
@@ -48,7 +85,6 @@ public:
 
 	Scheduler* getScheduler() const { return scheduler; }
 	ConfigManager* getConfig() const { return configManager; }
-    std::map<std::string, Process*> getProcesses() const { return processes; }
 	string getCurrentSessionName() const { return currentSessionName; }
 	bool isInSession() const { return inSession; }
 
@@ -0,0 +1,40 @@
+#ifndef CORECOUNTERS_H
+#define CORECOUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+
+// Cache line size used to keep per-core counters apart
+static constexpr size_t cacheLineSize = 64;
+
+// Accounting for one emulated core, padded to its own cache line.
+// Each block has a single writer at a time (the core's worker, or the dispatcher
+// under schedulerMutex), so updates are plain relaxed load/store pairs rather
+// than locked read-modify-writes, and no other core's counters share the line.
+// Readers sum the blocks without locking.
+struct alignas(cacheLineSize) CoreCounters {
+	std::atomic<unsigned long long> activeTicks{ 0 };    // Ticks of completed busy spans
+	std::atomic<unsigned long long> idleTicks{ 0 };      // Ticks of completed idle spans
+	std::atomic<unsigned long long> dispatches{ 0 };     // Slices started on this core
+	std::atomic<unsigned long long> preemptions{ 0 };    // Slices cut short by quantum expiry
+	std::atomic<unsigned long long> swapWaitTicks{ 0 };  // Ticks processes parked here waited on swap-ins
+	std::atomic<unsigned long long> idleSinceTick{ 0 };  // When the core last went idle
+	std::atomic<unsigned long long> busySinceTick{ 0 };  // When the core last picked up a process
+
+	static void add(std::atomic<unsigned long long>& counter, unsigned long long amount) {
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+};
+
+static_assert(sizeof(CoreCounters) == cacheLineSize, "CoreCounters must fill exactly one cache line");
+
+// Totals across all cores, as shown by vmstat and process-smi
+struct CpuStats {
+	unsigned long long activeTicks = 0;
+	unsigned long long idleTicks = 0;
+	unsigned long long dispatches = 0;
+	unsigned long long preemptions = 0;
+	unsigned long long swapWaitTicks = 0;
+};
+
+#endif // CORECOUNTERS_H
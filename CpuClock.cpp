@@ -0,0 +1,80 @@
+#include "CpuClock.h"
+
+CpuClock::CpuClock(std::chrono::milliseconds tickPeriod) : tickPeriod(tickPeriod) {
+}
+
+CpuClock::~CpuClock() {
+	stop();
+}
+
+void CpuClock::start() {
+	tickerThread = std::thread(&CpuClock::tickerLoop, this);
+}
+
+void CpuClock::stop() {
+	{
+		std::lock_guard<std::mutex> lock(clockMutex);
+		stopped = true;
+	}
+	tickCv.notify_all();
+	arrivedCv.notify_all();
+	if (tickerThread.joinable()) {
+		tickerThread.join();
+	}
+}
+
+unsigned long long CpuClock::join() {
+	std::lock_guard<std::mutex> lock(clockMutex);
+	participants++;
+	return tick;  // First tick of work is the next one
+}
+
+void CpuClock::arrive() {
+	std::lock_guard<std::mutex> lock(clockMutex);
+	if (--pending == 0) {
+		arrivedCv.notify_one();
+	}
+}
+
+void CpuClock::leave(unsigned long long lastTick) {
+	std::lock_guard<std::mutex> lock(clockMutex);
+	participants--;
+
+	// A tick that already started counted this core in; release the barrier for it
+	if (tick > lastTick && --pending == 0) {
+		arrivedCv.notify_one();
+	}
+}
+
+unsigned long long CpuClock::awaitTick(unsigned long long lastTick) {
+	std::unique_lock<std::mutex> lock(clockMutex);
+	tickCv.wait(lock, [&] { return tick > lastTick || stopped; });
+	return tick;
+}
+
+void CpuClock::tickerLoop() {
+	auto nextTickTime = std::chrono::steady_clock::now();
+
+	while (true) {
+		nextTickTime += tickPeriod;
+		std::this_thread::sleep_until(nextTickTime);
+
+		std::unique_lock<std::mutex> lock(clockMutex);
+
+		// Barrier: every core must finish the current tick before the clock moves on
+		arrivedCv.wait(lock, [&] { return pending <= 0 || stopped; });
+		if (stopped) {
+			return;
+		}
+
+		pending = participants;
+		tick++;
+		tickCv.notify_all();
+
+		// A core that overran its tick delays the clock instead of being skipped
+		auto now = std::chrono::steady_clock::now();
+		if (now > nextTickTime + tickPeriod) {
+			nextTickTime = now;
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef CPUCLOCK_H
+#define CPUCLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Shared CPU tick source for realtime mode.
+// A ticker thread advances a global epoch counter once per tick period, but only
+// after every participating core has finished its work for the current tick, so
+// all emulated cores move in lock-step regardless of host thread timing.
+class CpuClock {
+public:
+	CpuClock(std::chrono::milliseconds tickPeriod);
+	~CpuClock();
+
+	void start();
+	void stop();
+
+	unsigned long long getTick() const { return tick; }
+
+	// Cores holding a process participate in the barrier
+	unsigned long long join();                             // Returns the tick to pass to awaitTick
+	void arrive();                                         // Done with the current tick's work
+	void leave(unsigned long long lastTick);               // Stop participating after lastTick
+
+	// Blocks until the clock passes lastTick; observers may call this without joining
+	unsigned long long awaitTick(unsigned long long lastTick);
+
+private:
+	std::chrono::milliseconds tickPeriod;
+	std::atomic<unsigned long long> tick{ 0 };
+
+	std::mutex clockMutex;
+	std::condition_variable tickCv;     // Signals a new tick
+	std::condition_variable arrivedCv;  // Signals that every participant arrived
+	int participants = 0;               // Cores currently joined
+	int pending = 0;                    // Participants yet to arrive for the current tick
+	bool stopped = false;
+	std::thread tickerThread;
+
+	void tickerLoop();
+};
+
+#endif // CPUCLOCK_H
@@ -0,0 +1,29 @@
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+#include <cstdint>
+
+// One pre-decoded process instruction packed into 8 bytes.
+// Operands are variable slots unless the matching immediate flag is set,
+// in which case the operand holds a literal uint16 value.
+// FOR/END_FOR bracket a loop body; they steer the interpreter but take no CPU step.
+struct Instruction {
+	enum Opcode : uint8_t { PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR, END_FOR };
+
+	// Bits in flags marking operand1/operand2 as immediates
+	static constexpr uint8_t IMMEDIATE1 = 1 << 0;
+	static constexpr uint8_t IMMEDIATE2 = 1 << 1;
+
+	static constexpr int maxVariables = 32;  // Variable slots available to a process
+	static constexpr int maxLoopDepth = 3;   // Deepest FOR nesting
+
+	uint8_t opcode;
+	uint8_t flags;
+	uint16_t dest;      // Variable slot written by DECLARE/ADD/SUBTRACT, read by PRINT
+	uint16_t operand1;  // DECLARE value, first ADD/SUBTRACT operand, SLEEP ticks, FOR repeats
+	uint16_t operand2;  // Second ADD/SUBTRACT operand
+};
+
+static_assert(sizeof(Instruction) == 8, "Instruction must stay 8 bytes");
+
+#endif // INSTRUCTION_H
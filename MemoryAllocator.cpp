@@ -5,18 +5,42 @@
 #include <ctime>
 #include <cstdlib>
 #include <algorithm> 
+#include <bit>
 
 using namespace std;
 
-MemoryAllocator::MemoryAllocator(ConfigManager* configManager) {
+MemoryAllocator::MemoryAllocator(ConfigManager* configManager, Tracer* tracer)
+	: swapDevice(backingStorePath, configManager->getExecutionMode() == ConfigManager::ExecutionMode::REALTIME), tracer(tracer) {
 	maxOverallMem = configManager->getMaxOverallMem();
 	memPerFrame = configManager->getMemPerFrame();
 	minMemPerProcess = configManager->getMinMemPerProcess();
 	maxMemPerProcess = configManager->getMaxMemPerProcess();
+	fitPolicy = configManager->getFitPolicy();
+	allocatorType = configManager->getAllocatorType();
+	replacementPolicy = configManager->getReplacementPolicy();
 
 	if (isFlatAllocation()) {
-		for (int i = 0; i < maxOverallMem; ++i) {
-			memoryAddresses.push_back(i);
+		allocationBitmap.assign((maxOverallMem + 63) / 64, 0);
+	}
+	else if (allocatorType == ConfigManager::AllocatorType::PAGING) {
+		totalFrames = memPerFrame > 0 ? maxOverallMem / memPerFrame : 0;
+		frameTable.assign(totalFrames, { nullptr, -1, false, -1, -1 });
+		// Push in reverse so the lowest frame numbers are handed out first
+		for (int frame = totalFrames - 1; frame >= 0; frame--) {
+			freeFrames.push_back(frame);
+		}
+	}
+	else if (isBuddyAllocation()) {
+		// Carve memory into descending power-of-two root blocks. Each root starts at a multiple
+		// of twice its size, so its buddy address always falls past the end and never coalesces.
+		int maxOrder = std::bit_width(static_cast<unsigned int>(std::max(maxOverallMem, 1))) - 1;
+		buddyFreeBlocks.resize(maxOrder + 1);
+		int address = 0;
+		for (int order = maxOrder; order >= 0; order--) {
+			if (maxOverallMem & (1 << order)) {
+				buddyFreeBlocks[order].insert(address);
+				address += 1 << order;
+			}
 		}
 	}
 }
@@ -25,48 +49,84 @@ MemoryAllocator::~MemoryAllocator() {
 }
 
 bool MemoryAllocator::isFlatAllocation() const {
-	return memPerFrame == maxOverallMem;
+	return allocatorType == ConfigManager::AllocatorType::FLAT;
+}
+
+bool MemoryAllocator::isBuddyAllocation() const {
+	return allocatorType == ConfigManager::AllocatorType::BUDDY;
 }
 
 bool MemoryAllocator::isProcessInMemory(Process* process) const {
-	return processMap.find(process->getProcessName()) != processMap.end();
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	if (isBuddyAllocation()) {
+		return buddyMap.contains(process->getProcessId());
+	}
+	if (allocatorType == ConfigManager::AllocatorType::PAGING) {
+		return processPageMap.contains(process->getProcessId());
+	}
+	return processMap.contains(process->getProcessId());
+}
+
+bool MemoryAllocator::isProcessInBackingStore(Process* process) const {
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	return swapDevice.contains(process->getProcessId());
 }
 
 bool MemoryAllocator::allocateMemory(Process* process) {
-	if (isFlatAllocation()) {
-		return allocateFlatMemory(process);
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	bool allocated = false;
+	switch (allocatorType) {
+		case ConfigManager::AllocatorType::FLAT:
+			allocated = allocateFlatMemory(process);
+			break;
+		case ConfigManager::AllocatorType::PAGING:
+			allocated = allocatePagingMemory(process);
+			break;
+		case ConfigManager::AllocatorType::BUDDY:
+			allocated = allocateBuddyMemory(process);
+			break;
 	}
-	else {
-		return allocatePagingMemory(process);
+	if (allocated) {
+		tracer->recordHere(Tracer::ALLOCATE, process->getProcessId(), process->getNumPages());
 	}
-	return false;
+	return allocated;
 }
 
 void MemoryAllocator::deallocateMemory(Process* process) {
-	if (isFlatAllocation()) {
-		removeFlatMemory(process);
-	}
-	else {
-		removePagingMemory(process);
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	// A process evicted while it was still running finishes without being paged back in
+	swapDevice.discard(static_cast<uint32_t>(process->getProcessId()));
+	switch (allocatorType) {
+		case ConfigManager::AllocatorType::FLAT:
+			removeFlatMemory(process);
+			break;
+		case ConfigManager::AllocatorType::PAGING:
+			removePagingMemory(process);
+			break;
+		case ConfigManager::AllocatorType::BUDDY:
+			removeBuddyMemory(process);
+			break;
 	}
 }
 
 
 bool MemoryAllocator::allocateFlatMemory(Process* process) {
-	std::string processName = process->getProcessName();
-
 	int memRequired = process->getMemorySize();
 
-	if (maxOverallMem - allocatedAddresses.size() < memRequired) {
+	if (maxOverallMem - usedFlatMemory < memRequired) {
 		// Not enough memory, find the oldest process
-		auto oldestProcess = std::min_element(processMap.begin(), processMap.end(),
-			[](const auto& a, const auto& b) {
-				return a.second.allocationTime < b.second.allocationTime;
-			});
-
-		if (oldestProcess != processMap.end()) {
-			saveProcessToBackingStore(oldestProcess->second.process);
-			removeFlatMemory(oldestProcess->second.process);
+		Process* oldestProcess = nullptr;
+		unsigned long long oldestOrder = 0;
+		processMap.forEach([&](int, const ProcessAllocated& allocation) {
+			if (oldestProcess == nullptr || allocation.allocationOrder < oldestOrder) {
+				oldestProcess = allocation.process;
+				oldestOrder = allocation.allocationOrder;
+			}
+		});
+
+		if (oldestProcess != nullptr) {
+			saveProcessToBackingStore(oldestProcess);
+			removeFlatMemory(oldestProcess);
 		}
 		else {
 			// No processes to remove, allocation fails
@@ -74,225 +134,452 @@ bool MemoryAllocator::allocateFlatMemory(Process* process) {
 		}
 	}
 
-	int consecutiveFreeAddresses = 0;
-	int startIndex = -1;
+	int startIndex = findFreeRun(memRequired);
+	if (startIndex == -1) {
+		return false;
+	}
+
+	setRange(startIndex, memRequired, true);
+	nextFitCursor = (startIndex + memRequired) % maxOverallMem;
 
-	// Find consecutive free addresses
-	for (int i = 0; i < maxOverallMem; ++i) {
-		if (find(allocatedAddresses.begin(), allocatedAddresses.end(), memoryAddresses[i]) == allocatedAddresses.end()) {
-			// Address is free
-			++consecutiveFreeAddresses;
-			if (startIndex == -1) {
-				startIndex = i;
-			}
+	int endIndex = startIndex + memRequired - 1;
+	processMap[process->getProcessId()] = { process, startIndex, endIndex, nextAllocationOrder++ };
+	return true;
+}
+
+// Finds the next run of free addresses starting at or after from and ending before limit.
+// Whole words that are fully allocated or fully free are skipped in one step.
+bool MemoryAllocator::nextFreeRun(int from, int limit, int& runStart, int& runLength) const {
+	int pos = from;
+
+	// Skip allocated addresses
+	while (pos < limit) {
+		uint64_t freeBits = ~allocationBitmap[pos / 64] >> (pos % 64);
+		if (freeBits != 0) {
+			pos += std::countr_zero(freeBits);
+			break;
 		}
-		else {
-			consecutiveFreeAddresses = 0;
-			startIndex = -1;
+		pos = (pos / 64 + 1) * 64;
+	}
+	if (pos >= limit) {
+		return false;
+	}
+	runStart = pos;
+
+	// Extend over free addresses
+	while (pos < limit) {
+		uint64_t usedBits = allocationBitmap[pos / 64] >> (pos % 64);
+		if (usedBits != 0) {
+			pos += std::countr_zero(usedBits);
+			break;
 		}
+		pos = (pos / 64 + 1) * 64;
+	}
+	runLength = std::min(pos, limit) - runStart;
+	return true;
+}
 
-		if (consecutiveFreeAddresses >= memRequired) {
-			for (int j = startIndex; j < startIndex + memRequired; ++j) {
-				allocatedAddresses.push_back(memoryAddresses[j]);
+int MemoryAllocator::findFreeRun(int memRequired) const {
+	int runStart, runLength;
+
+	if (fitPolicy == ConfigManager::FitPolicy::BEST_FIT) {
+		// Smallest free run that still fits
+		int bestStart = -1, bestLength = 0;
+		for (int pos = 0; nextFreeRun(pos, maxOverallMem, runStart, runLength); pos = runStart + runLength) {
+			if (runLength >= memRequired && (bestStart == -1 || runLength < bestLength)) {
+				bestStart = runStart;
+				bestLength = runLength;
+				if (runLength == memRequired) {
+					break;  // Exact fit, can't do better
+				}
 			}
+		}
+		return bestStart;
+	}
 
-			int endIndex = startIndex + memRequired - 1;
-			processMap[processName] = { process, startIndex, endIndex, time(0) };
-			return true;
+	// First fit scans from address 0; next fit resumes after the previous allocation and wraps around
+	int cursor = fitPolicy == ConfigManager::FitPolicy::NEXT_FIT ? nextFitCursor : 0;
+	for (int pos = cursor; nextFreeRun(pos, maxOverallMem, runStart, runLength); pos = runStart + runLength) {
+		if (runLength >= memRequired) {
+			return runStart;
 		}
 	}
-	return false;
+	for (int pos = 0; nextFreeRun(pos, cursor, runStart, runLength); pos = runStart + runLength) {
+		// A run cut short by the cursor may continue past it
+		if (runStart + runLength == cursor) {
+			int tailStart, tailLength;
+			if (nextFreeRun(cursor, maxOverallMem, tailStart, tailLength) && tailStart == cursor) {
+				runLength += tailLength;
+			}
+		}
+		if (runLength >= memRequired) {
+			return runStart;
+		}
+	}
+	return -1;
+}
+
+void MemoryAllocator::setRange(int start, int length, bool allocated) {
+	int pos = start;
+	int end = start + length;
+	while (pos < end) {
+		int bit = pos % 64;
+		int count = std::min(64 - bit, end - pos);
+		uint64_t mask = (count == 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1)) << bit;
+		if (allocated) {
+			allocationBitmap[pos / 64] |= mask;
+		}
+		else {
+			allocationBitmap[pos / 64] &= ~mask;
+		}
+		pos += count;
+	}
+	usedFlatMemory += allocated ? length : -length;
 }
 
 
 void MemoryAllocator::removeFlatMemory(Process* process) {
-	std::string processName = process->getProcessName();
-	auto it = processMap.find(processName);
-	if (it != processMap.end()) {
-		int startIndex = it->second.startAddressIndex;
-		int endIndex = it->second.endAddressIndex;
-		for (int i = startIndex; i <= endIndex; ++i) {
-			// Remove allocated addresses from the allocatedAddresses vector
-			allocatedAddresses.erase(remove(allocatedAddresses.begin(), allocatedAddresses.end(), memoryAddresses[i]), allocatedAddresses.end());
-		}
-		processMap.erase(it);
+	ProcessAllocated* allocation = processMap.find(process->getProcessId());
+	if (allocation != nullptr) {
+		setRange(allocation->startAddressIndex, allocation->endAddressIndex - allocation->startAddressIndex + 1, false);
+		processMap.erase(process->getProcessId());
 	}
 }
 
 
 void MemoryAllocator::showFlatMemory() {
+	std::lock_guard<std::mutex> lock(memoryMutex);
 	cout << "Flat memory allocation:" << endl;
 	cout << "-----------------------" << endl;
 	cout << "Max overall memory: " << maxOverallMem << endl;
-	cout << "Memory usage: " << allocatedAddresses.size() << " KB / " << maxOverallMem << " KB" << endl;
+	cout << "Memory usage: " << usedFlatMemory << " KB / " << maxOverallMem << " KB" << endl;
 	// Display process names and corresponding memory size
-	for (auto& entry : processMap) {
-		cout << "Process: " << entry.first << " (Memory size: " << entry.second.endAddressIndex - entry.second.startAddressIndex + 1 << ")" << endl;
-	}
+	processMap.forEach([](int, const ProcessAllocated& allocation) {
+		cout << "Process: " << allocation.process->getProcessName() << " (Memory size: " << allocation.endAddressIndex - allocation.startAddressIndex + 1 << ")" << endl;
+	});
 	cout << endl;
 }
 
 bool MemoryAllocator::allocatePagingMemory(Process* process) {
-	std::string processName = process->getProcessName();
+	if (processPageMap.contains(process->getProcessId())) {
+		return true;  // Already admitted
+	}
+	if (totalFrames == 0) {
+		return false;  // No frame to fault pages into
+	}
+
+	// Nothing is resident yet; pages are faulted in as instructions touch them
 	int pagesRequired = (process->getMemorySize() + memPerFrame - 1) / memPerFrame;
+	PageTable& pageTable = processPageMap[process->getProcessId()];
+	pageTable.process = process;
+	pageTable.frames.assign(pagesRequired, -1);
+	pageTable.swapped.assign(pagesRequired, false);
 
-	// Check if there are enough free frames
-	if (frameList.size() + pagesRequired > maxOverallMem / memPerFrame) {
-		// Not enough frames, find the oldest process
-		auto oldestProcessIt = std::min_element(processPageMap.begin(), processPageMap.end(),
-			[](const auto& a, const auto& b) {
-				return a.second.first < b.second.first; // Compare allocation times of processes
-			});
+	return true;
+}
 
-		if (oldestProcessIt != processPageMap.end()) {
-			std::string oldestProcessName = oldestProcessIt->first;
+void MemoryAllocator::removePagingMemory(Process* process) {
+	PageTable* pageTable = processPageMap.find(process->getProcessId());
+	if (pageTable != nullptr) {
+		// Only the resident frames in this process's page table are touched
+		for (int frame : pageTable->frames) {
+			if (frame != -1) {
+				unlinkFrame(frame);
+				frameTable[frame] = { nullptr, -1, false, -1, -1 };
+				freeFrames.push_back(frame);
+			}
+		}
 
-			// Remove pages of the oldest process from frameList
-			frameList.erase(std::remove_if(frameList.begin(), frameList.end(),
-				[&](const Page& page) { return page.process->getProcessName() == oldestProcessName; }), frameList.end());
+		processPageMap.erase(process->getProcessId()); // Remove the process entry from the map
+	}
+}
 
-			// get the process object from a page in the frameList with a process name that matches the oldest process name
-			auto oldestProcessPage = std::find_if(
-				frameList.begin(), frameList.end(),
-				[&](const Page& page) { return page.process->getProcessName() == oldestProcessName; }
-			);
-			
-			saveProcessToBackingStore(oldestProcessPage->process);
+void MemoryAllocator::accessPages(Process* process) {
+	if (allocatorType != ConfigManager::AllocatorType::PAGING) {
+		return;
+	}
 
-			// Remove the oldest process from processPageMap
-			processPageMap.erase(oldestProcessIt);
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	// Every instruction reads the process's variables on page 0 and its own code page
+	accessPage(process, 0);
+	accessPage(process, process->getCurrentPage());
+}
 
+void MemoryAllocator::accessPage(Process* process, int pageNumber) {
+	PageTable* entry = processPageMap.find(process->getProcessId());
+	if (entry == nullptr || pageNumber >= static_cast<int>(entry->frames.size())) {
+		return;
+	}
+	PageTable& pageTable = *entry;
+
+	int frame = pageTable.frames[pageNumber];
+	if (frame != -1) {
+		// Hit: LRU moves the frame to the most recent end, CLOCK gives it a second chance
+		if (replacementPolicy == ConfigManager::ReplacementPolicy::LRU) {
+			unlinkFrame(frame);
+			linkFrame(frame);
 		}
-		else {
-			// No processes to remove, allocation fails
-			return false;
-		}
+		frameTable[frame].referenced = true;
+		return;
 	}
 
-	// Allocate pages to the process
-	for (int i = 0; i < pagesRequired; ++i) {
-		Page newPage = { process, i };
-		frameList.push_back(newPage);
-		processPageMap[processName].second.push_back(i); // Add page number to the vector
+	numPageFaults++;
+	if (freeFrames.empty()) {
+		evictFrame(selectVictimFrame());
 	}
+	frame = freeFrames.back();
+	freeFrames.pop_back();
 
-	// Set allocation time for the process (only when it's first allocated)
-	if (processPageMap[processName].first == 0) {
-		processPageMap[processName].first = time(0);
+	if (pageTable.swapped[pageNumber]) {
+		numPagesIn++;
+		pageTable.swapped[pageNumber] = false;
 	}
+	frameTable[frame] = { process, pageNumber, true, -1, -1 };
+	linkFrame(frame);
+	pageTable.frames[pageNumber] = frame;
+	pageTable.residentPages++;
+}
 
-	return true;
+int MemoryAllocator::selectVictimFrame() {
+	if (replacementPolicy != ConfigManager::ReplacementPolicy::CLOCK) {
+		return residentHead;  // Oldest load for FIFO, least recent use for LRU
+	}
+
+	// Sweep the hand, clearing reference bits, until a frame without one turns up
+	while (true) {
+		Frame& candidate = frameTable[clockHand];
+		int frame = clockHand;
+		clockHand = (clockHand + 1) % totalFrames;
+		if (candidate.process == nullptr) {
+			continue;
+		}
+		if (!candidate.referenced) {
+			return frame;
+		}
+		candidate.referenced = false;
+	}
 }
 
-void MemoryAllocator::removePagingMemory(Process* process) {
-	std::string processName = process->getProcessName();
-	auto it = processPageMap.find(processName);
-	if (it != processPageMap.end()) {
-		// No need to iterate over page numbers, just remove all pages of the process
-		frameList.erase(std::remove_if(frameList.begin(), frameList.end(),
-			[&](const Page& page) {
-				return page.process->getProcessName() == processName;
-			}), frameList.end());
+void MemoryAllocator::evictFrame(int frame) {
+	Frame& victim = frameTable[frame];
+	PageTable& owner = *processPageMap.find(victim.process->getProcessId());
+	owner.frames[victim.pageNumber] = -1;
+	owner.swapped[victim.pageNumber] = true;
+	owner.residentPages--;
+	numPagesOut++;
+	tracer->recordHere(Tracer::EVICT, victim.process->getProcessId(), 1);
+
+	unlinkFrame(frame);
+	frameTable[frame] = { nullptr, -1, false, -1, -1 };
+	freeFrames.push_back(frame);
+}
 
-		processPageMap.erase(it); // Remove the process entry from the map
+void MemoryAllocator::linkFrame(int frame) {
+	// Append at the most recent end
+	frameTable[frame].prev = residentTail;
+	frameTable[frame].next = -1;
+	if (residentTail != -1) {
+		frameTable[residentTail].next = frame;
+	}
+	else {
+		residentHead = frame;
 	}
+	residentTail = frame;
+}
+
+void MemoryAllocator::unlinkFrame(int frame) {
+	Frame& entry = frameTable[frame];
+	if (entry.prev != -1) {
+		frameTable[entry.prev].next = entry.next;
+	}
+	else {
+		residentHead = entry.next;
+	}
+	if (entry.next != -1) {
+		frameTable[entry.next].prev = entry.prev;
+	}
+	else {
+		residentTail = entry.prev;
+	}
+	entry.prev = -1;
+	entry.next = -1;
 }
 
 void MemoryAllocator::showPagingMemory() {
+	std::lock_guard<std::mutex> lock(memoryMutex);
 	cout << "Paging memory allocation:" << endl;
 	cout << "-------------------------" << endl;
-	cout << "Total frames: " << maxOverallMem / memPerFrame << endl;
-	cout << "Used frames: " << frameList.size() << endl;
-	cout << "Free frames: " << maxOverallMem / memPerFrame - frameList.size() << endl;
-
-	// Display processes and their allocated pages
-	for (const auto& entry : processPageMap) {
-		cout << "Process: " << entry.first << "Pages: ";
-		for (int pageNumber : entry.second.second) { // Access the page numbers from the pair
-			cout << pageNumber << " ";
+	cout << "Total frames: " << totalFrames << endl;
+	cout << "Used frames: " << totalFrames - freeFrames.size() << endl;
+	cout << "Free frames: " << freeFrames.size() << endl;
+
+	// Display processes and their resident pages
+	processPageMap.forEach([](int, const PageTable& pageTable) {
+		cout << "Process: " << pageTable.process->getProcessName() << " Frames: ";
+		for (int frame : pageTable.frames) { // Frame backing each page, in page order
+			if (frame == -1) {
+				cout << "- ";
+			}
+			else {
+				cout << frame << " ";
+			}
 		}
 		cout << endl;
-	}
+	});
 	cout << endl;
 }
 
-void MemoryAllocator::saveProcessToBackingStore(Process* process) {
-	std::string processName = process->getProcessName();
-	std::string filePath = backingStorePath + "/" + processName + ".txt";
+bool MemoryAllocator::allocateBuddyMemory(Process* process) {
+	int memRequired = std::max(process->getMemorySize(), 1);
+	int order = std::bit_width(static_cast<unsigned int>(memRequired - 1));
 
-	std::filesystem::create_directories(backingStorePath);
+	if (order >= static_cast<int>(buddyFreeBlocks.size())) {
+		return false;  // Larger than the biggest block memory can hold
+	}
 
-	std::ofstream file(filePath);
+	while (true) {
+		// Smallest free block that is big enough
+		int blockOrder = order;
+		while (blockOrder < static_cast<int>(buddyFreeBlocks.size()) && buddyFreeBlocks[blockOrder].empty()) {
+			blockOrder++;
+		}
 
-	if (file.is_open()) {
-		file << process->getProcessName() << std::endl;
-		file << std::hex << reinterpret_cast<uintptr_t>(process) << std::dec <<std::endl;
-		file << "Executed Instructions: " << std::endl;
-		file << process->getCommandIndex() << std::endl;
-		file << "Total Instructions: " << std::endl;
-		file << process->getTotalCommands() << std::endl;
-		file << "Memory Size: " << std::endl;
-		file << process->getMemorySize() << std::endl;
-		file << "Number of Pages: " << std::endl;
-		file << process->getNumPages() << std::endl;
+		if (blockOrder < static_cast<int>(buddyFreeBlocks.size())) {
+			int address = *buddyFreeBlocks[blockOrder].begin();
+			buddyFreeBlocks[blockOrder].erase(buddyFreeBlocks[blockOrder].begin());
 
-		file.close();
+			// Split down to the requested order, freeing the upper halves
+			while (blockOrder > order) {
+				blockOrder--;
+				buddyFreeBlocks[blockOrder].insert(address + (1 << blockOrder));
+			}
 
-		numPagesOut += process->getNumPages();
-		backingStoreSet.insert(processName);
-	}
-	else {
-		std::cerr << "Error: Unable to open file for saving process to backing store." << std::endl;
+			buddyMap[process->getProcessId()] = { process, address, order, nextAllocationOrder++ };
+			usedBuddyMemory += 1 << order;
+			buddyInternalFragmentation += (1 << order) - memRequired;
+			return true;
+		}
+
+		// No block fits; evict the oldest process and try again
+		Process* victim = nullptr;
+		unsigned long long oldestOrder = 0;
+		buddyMap.forEach([&](int, const BuddyBlock& block) {
+			if (victim == nullptr || block.allocationOrder < oldestOrder) {
+				victim = block.process;
+				oldestOrder = block.allocationOrder;
+			}
+		});
+
+		if (victim == nullptr) {
+			return false;
+		}
+		saveProcessToBackingStore(victim);
+		removeBuddyMemory(victim);
 	}
 }
 
-Process* MemoryAllocator::loadProcessFromBackingStore(const std::string& processName) {
-	std::string filePath = backingStorePath + "/" + processName + ".txt";
-
-	std::ifstream file(filePath);
-	if (file.is_open()) {
-		uintptr_t processAddress;
-		std::string name;
-		int commandIndex, totalCommands, memorySize, numPages;
+void MemoryAllocator::removeBuddyMemory(Process* process) {
+	BuddyBlock* block = buddyMap.find(process->getProcessId());
+	if (block != nullptr) {
+		int blockSize = 1 << block->order;
+		usedBuddyMemory -= blockSize;
+		buddyInternalFragmentation -= blockSize - std::max(process->getMemorySize(), 1);
+		freeBuddyBlock(block->address, block->order);
+		buddyMap.erase(process->getProcessId());
+	}
+}
 
-		file >> name;
-		file >> std::hex >> processAddress;
-		file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		file >> commandIndex;
-		file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		file >> totalCommands;
-		file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		file >> memorySize;
-		file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-		file >> numPages;
+void MemoryAllocator::freeBuddyBlock(int address, int order) {
+	// Coalesce with the buddy for as long as it is free at the same order
+	while (order + 1 < static_cast<int>(buddyFreeBlocks.size())) {
+		int buddyAddress = address ^ (1 << order);
+		auto buddy = buddyFreeBlocks[order].find(buddyAddress);
+		if (buddy == buddyFreeBlocks[order].end()) {
+			break;
+		}
+		buddyFreeBlocks[order].erase(buddy);
+		address = std::min(address, buddyAddress);
+		order++;
+	}
+	buddyFreeBlocks[order].insert(address);
+}
 
-		file.close();
+void MemoryAllocator::showBuddyFreeBlocks() {
+	cout << "Free blocks per order:" << endl;
+	for (int order = 0; order < static_cast<int>(buddyFreeBlocks.size()); order++) {
+		cout << setw(9) << buddyFreeBlocks[order].size() << "  x " << (1 << order) << " KB" << endl;
+	}
+}
 
+void MemoryAllocator::saveProcessToBackingStore(Process* process) {
+	BackingStore::SwapRecord record = {
+		static_cast<uint32_t>(process->getProcessId()),
+		static_cast<uint32_t>(process->getCommandIndex()),
+		static_cast<uint32_t>(process->getTotalCommands()),
+		static_cast<uint32_t>(process->getMemorySize()),
+		static_cast<uint32_t>(process->getNumPages()),
+		1
+	};
+
+	// Written behind by the swap I/O thread; eviction doesn't wait for it
+	swapDevice.pageOut(record);
+	numPagesOut += process->getNumPages();
+	tracer->recordHere(Tracer::EVICT, process->getProcessId(), process->getNumPages());
+}
 
-		Process* loadedProcess = reinterpret_cast<Process*>(processAddress);
+bool MemoryAllocator::loadProcessFromBackingStore(Process* process) {
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	SwapDevice::SwapRecord record;
+	auto completion = [this, process](const SwapDevice::SwapRecord& loaded) {
+		std::function<void(Process*)> handler;
+		{
+			std::lock_guard<std::mutex> lock(memoryMutex);
+			numPagesIn += loaded.numPages;
+			handler = swapInHandler;
+		}
+		tracer->recordHere(Tracer::SWAP_IN, process->getProcessId(), loaded.numPages);
+		if (handler) {
+			handler(process);
+		}
+	};
 
-		numPagesIn += loadedProcess->getNumPages();
+	switch (swapDevice.pageIn(static_cast<uint32_t>(process->getProcessId()), record, completion)) {
+		case SwapDevice::PageInResult::COMPLETED:
+			numPagesIn += record.numPages;
+			tracer->recordHere(Tracer::SWAP_IN, process->getProcessId(), record.numPages);
+			return true;
+		case SwapDevice::PageInResult::PENDING:
+			return false;
+		case SwapDevice::PageInResult::NOT_SWAPPED:
+			break;
+	}
+	return true;
+}
 
-		backingStoreSet.erase(processName);
+MemoryAllocator::MemoryStats MemoryAllocator::getMemoryStats() const {
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	return { numPagesIn, numPagesOut, numPageFaults, swapDevice.getBatchCount() };
+}
 
-		return loadedProcess;
-	}
-	else {
-		std::cerr << "Error: Unable to open file for loading process from backing store." << std::endl;
-		return nullptr;
-	}
+void MemoryAllocator::setSwapInHandler(std::function<void(Process*)> handler) {
+	std::lock_guard<std::mutex> lock(memoryMutex);
+	swapInHandler = std::move(handler);
 }
 
-void MemoryAllocator::showProcessSMI(double cpuUtil) {
+void MemoryAllocator::showProcessSMI(double cpuUtil, const CpuStats& cpuStats) {
+	std::lock_guard<std::mutex> lock(memoryMutex);
 	int usedMemory, totalMemory;
 
 	if (isFlatAllocation()) {
-		usedMemory = allocatedAddresses.size();
+		usedMemory = usedFlatMemory;
+		totalMemory = maxOverallMem;
+	}
+	else if (isBuddyAllocation()) {
+		usedMemory = usedBuddyMemory;
 		totalMemory = maxOverallMem;
 	}
 	else { // Paging allocation
-		int usedFrames = frameList.size();
-		int totalFrames = maxOverallMem / memPerFrame;
+		int usedFrames = totalFrames - freeFrames.size();
 		usedMemory = usedFrames * memPerFrame;
 		totalMemory = totalFrames * memPerFrame;
 	}
@@ -304,47 +591,76 @@ void MemoryAllocator::showProcessSMI(double cpuUtil) {
 	cout << "|  PROCESS-SMI V01.00 Driver Version: 01.00     |" << endl;
 	cout << "-------------------------------------------------" << endl;
 	cout << "CPU-Util: " << cpuUtil << "%" << endl;
+	cout << "CPU Ticks: " << cpuStats.activeTicks << " active / " << cpuStats.activeTicks + cpuStats.idleTicks << " total" << endl;
+	cout << "Dispatches: " << cpuStats.dispatches << "   Preemptions: " << cpuStats.preemptions << endl;
 	cout << "Memory Usage: " << usedMemory << " KB / " << totalMemory << " KB" << endl;
-	cout << "Memory Util: " << memoryUtil << "%" << endl << endl;
+	cout << "Memory Util: " << memoryUtil << "%" << endl;
+	if (isBuddyAllocation()) {
+		cout << "Internal Fragmentation: " << buddyInternalFragmentation << " KB" << endl;
+		showBuddyFreeBlocks();
+	}
+	cout << endl;
 	cout << "-------------------------------------------------" << endl;
 	cout << "|  Running Processes and Memory Usage:          |" << endl;
 	cout << "-------------------------------------------------" << endl;
 
 	// Display process names and corresponding memory size
 	if (isFlatAllocation()) {
-		for (const auto& entry : processMap) {
-			cout << setw(12) << entry.first << "  " << entry.second.endAddressIndex - entry.second.startAddressIndex + 1 << "KB" << endl;
-		}
+		processMap.forEach([](int, const ProcessAllocated& allocation) {
+			cout << setw(12) << allocation.process->getProcessName() << "  " << allocation.endAddressIndex - allocation.startAddressIndex + 1 << "KB" << endl;
+		});
+	}
+	else if (isBuddyAllocation()) {
+		buddyMap.forEach([](int, const BuddyBlock& block) {
+			cout << setw(12) << block.process->getProcessName() << "  " << (1 << block.order) << "KB" << endl;
+		});
 	}
 	else { // Paging allocation
-		for (const auto& entry : processPageMap) {
-			cout << setw(12) << entry.first << "  ";
-			cout << entry.second.second.size() * memPerFrame << " KB" << endl;
-		}
+		processPageMap.forEach([this](int, const PageTable& pageTable) {
+			cout << setw(12) << pageTable.process->getProcessName() << "  ";
+			cout << pageTable.residentPages * memPerFrame << " KB resident / " << pageTable.frames.size() * memPerFrame << " KB" << endl;
+		});
 	}
 	
 	cout << endl << endl;
 }
 
-void MemoryAllocator::showVmStat(int idleCpuTicks, int activeCpuTicks) {
+void MemoryAllocator::showVmStat(const CpuStats& cpuStats) {
+	std::lock_guard<std::mutex> lock(memoryMutex);
 	cout << "-------------------------------------------------" << endl;
 	cout << " VMSTAT" << endl;
 	cout << "-------------------------------------------------" << endl;
 	cout << setw(9) << maxOverallMem << "  Total Memory" << endl;
 	if (isFlatAllocation()) {
-		cout << setw(9) << allocatedAddresses.size() << "  Used Memory" << endl;
-		cout << setw(9) << maxOverallMem - allocatedAddresses.size() << "  Free Memory" << endl;
+		cout << setw(9) << usedFlatMemory << "  Used Memory" << endl;
+		cout << setw(9) << maxOverallMem - usedFlatMemory << "  Free Memory" << endl;
+	}
+	else if (isBuddyAllocation()) {
+		cout << setw(9) << usedBuddyMemory << "  Used Memory" << endl;
+		cout << setw(9) << maxOverallMem - usedBuddyMemory << "  Free Memory" << endl;
+		cout << setw(9) << buddyInternalFragmentation << "  Internal fragmentation" << endl;
 	}
 	else { // Paging allocation
-		int usedFrames = frameList.size();
-		int totalFrames = maxOverallMem / memPerFrame;
+		int usedFrames = totalFrames - freeFrames.size();
 		cout << setw(9) << usedFrames * memPerFrame << "  Used Memory" << endl;
 		cout << setw(9) << (totalFrames - usedFrames) * memPerFrame << "  Free Memory" << endl;
 	}
-	cout << setw(9) << idleCpuTicks << "  Idle CPU ticks" << endl;
-	cout << setw(9) << activeCpuTicks << "  Active CPU ticks" << endl;
-	cout << setw(9) << idleCpuTicks + activeCpuTicks  << "  Total CPU ticks" << endl;
+	cout << setw(9) << cpuStats.idleTicks << "  Idle CPU ticks" << endl;
+	cout << setw(9) << cpuStats.activeTicks << "  Active CPU ticks" << endl;
+	cout << setw(9) << cpuStats.idleTicks + cpuStats.activeTicks  << "  Total CPU ticks" << endl;
+	cout << setw(9) << cpuStats.dispatches << "  Dispatches" << endl;
+	cout << setw(9) << cpuStats.preemptions << "  Preemptions" << endl;
+	cout << setw(9) << cpuStats.swapWaitTicks << "  Swap-wait ticks" << endl;
 	cout << setw(9) << numPagesOut << "  Pages paged out" << endl;
-	cout << setw(9) << numPagesIn << "  Pages paged in" << endl << endl;
+	cout << setw(9) << numPagesIn << "  Pages paged in" << endl;
+	cout << setw(9) << swapDevice.getBatchCount() << "  Swap write batches" << endl;
+	if (allocatorType == ConfigManager::AllocatorType::PAGING) {
+		cout << setw(9) << numPageFaults << "  Page faults" << endl;
+	}
+	cout << endl;
+	if (isBuddyAllocation()) {
+		showBuddyFreeBlocks();
+		cout << endl;
+	}
 	cout << "-------------------------------------------------" << endl<< endl;
 }
\ No newline at end of file
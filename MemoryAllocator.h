@@ -1,6 +1,10 @@
 #pragma once
 
 #include "ConfigManager.h"
+#include "SwapDevice.h"
+#include "PidMap.h"
+#include "CoreCounters.h"
+#include "Tracer.h"
 #include <vector>
 #include <unordered_map>
 #include "Process.h"
@@ -14,10 +18,13 @@
 #include <deque>
 #include <queue>
 #include <unordered_set>
+#include <set>
+#include <cstdint>
+#include <functional>
 
 class MemoryAllocator {
 public:
-  MemoryAllocator(ConfigManager* configManager);
+  MemoryAllocator(ConfigManager* configManager, Tracer* tracer);
   ~MemoryAllocator();
 
   void showFlatMemory();
@@ -25,53 +32,120 @@ public:
   bool allocateMemory(Process* process);
 	void deallocateMemory(Process* process);
 
+  // Paging mode faults in the pages the process's next instruction touches; no-op otherwise
+  void accessPages(Process* process);
+
   bool isProcessInMemory(Process* process) const;
+  bool isProcessInBackingStore(Process* process) const;
   bool isFlatAllocation() const;
+  bool isBuddyAllocation() const;
 
   int numPagesIn = 0;
   int numPagesOut = 0;
+  int numPageFaults = 0;
+
+  // False while the swap-in is still in flight; the handler receives the process once it completes
+  bool loadProcessFromBackingStore(Process* process);
+  void setSwapInHandler(std::function<void(Process*)> handler);
+  void stop() { swapDevice.stop(); }  // Joins the swap I/O thread once the scheduler has stopped
+
+  // Paging and swap counters read under memoryMutex, for batch-mode results
+  struct MemoryStats {
+    int pagesIn;
+    int pagesOut;
+    int pageFaults;
+    unsigned long long swapWriteBatches;
+  };
+  MemoryStats getMemoryStats() const;
 
-  std::unordered_set<std::string> backingStoreSet;
-  Process* loadProcessFromBackingStore(const std::string& processName);
-
-  void showProcessSMI(double cpuUtil);
-  void showVmStat(int idleCpuTicks, int activeCpuTicks);
+  void showProcessSMI(double cpuUtil, const CpuStats& cpuStats);
+  void showVmStat(const CpuStats& cpuStats);
 
 private:
   int maxOverallMem;     // Max overall memory
   int memPerFrame;       // Memory per frame
   int minMemPerProcess;  // Minimum memory per process
   int maxMemPerProcess;  // Maximum memory per process
+  ConfigManager::AllocatorType allocatorType;
+  mutable std::mutex memoryMutex;  // Public methods lock this; worker threads fault pages in outside schedulerMutex
+  unsigned long long nextAllocationOrder = 1;  // Orders allocations for oldest-first eviction, independent of wall time
 
   // Flat memory allocation members
   struct ProcessAllocated {
     Process* process;
 		int startAddressIndex;
     int endAddressIndex;
-		time_t allocationTime;
+		unsigned long long allocationOrder;  // Lower values were allocated earlier
   };
 
-	std::vector<bool> memorySlots;
-  std::vector<int> memoryAddresses; // Vector to store memory addresses
-  std::vector<int> allocatedAddresses; // Vector to track allocated addresses
-  std::unordered_map<std::string, ProcessAllocated> processMap;
+  // One bit per KB of flat memory, set when allocated, scanned a 64-bit word at a time
+  std::vector<uint64_t> allocationBitmap;
+  int usedFlatMemory = 0;   // KB currently allocated
+  int nextFitCursor = 0;    // Where the next next-fit search starts
+  ConfigManager::FitPolicy fitPolicy;
+  PidMap<ProcessAllocated> processMap;  // Keyed by process ID
 
   bool allocateFlatMemory(Process* process);
   void removeFlatMemory(Process* process);
+  bool nextFreeRun(int from, int limit, int& runStart, int& runLength) const;
+  int findFreeRun(int memRequired) const;
+  void setRange(int start, int length, bool allocated);
 
-  struct Page {
-    Process* process;
+  // Paging allocation members: pages are faulted in on first touch and evicted one at a time
+  struct Frame {
+    Process* process;  // Owner of the page held in this frame, nullptr when free
     int pageNumber;
+    bool referenced;   // CLOCK second-chance bit
+    int prev;          // Neighbours in the FIFO/LRU order, -1 at either end
+    int next;
   };
 
-  std::deque<Page> frameList; // Deque to represent the frame list
-  std::unordered_map<std::string, std::pair<time_t, std::vector<int>>> processPageMap;  // Store page numbers for each process
+  struct PageTable {
+    Process* process;
+    std::vector<int> frames;    // Frame number backing each page, -1 when not resident
+    std::vector<bool> swapped;  // Page was evicted and must be paged back in
+    int residentPages = 0;
+  };
+
+  int totalFrames = 0;
+  std::vector<Frame> frameTable;  // One descriptor per physical frame
+  std::vector<int> freeFrames;    // Stack of free frame numbers
+  PidMap<PageTable> processPageMap;  // Page table for each admitted process, keyed by process ID
+  ConfigManager::ReplacementPolicy replacementPolicy;
+  int residentHead = -1;  // Oldest (FIFO) or least recently used (LRU) resident frame
+  int residentTail = -1;
+  int clockHand = 0;
 
   bool allocatePagingMemory(Process* process);
   void removePagingMemory(Process* process);
+  void accessPage(Process* process, int pageNumber);
+  int selectVictimFrame();
+  void evictFrame(int frame);
+  void linkFrame(int frame);
+  void unlinkFrame(int frame);
+
+  // Buddy allocation members: blocks of 2^order KB, free blocks indexed by start address per order
+  struct BuddyBlock {
+    Process* process;
+    int address;
+    int order;
+    unsigned long long allocationOrder;
+  };
+
+  std::vector<std::set<int>> buddyFreeBlocks;
+  PidMap<BuddyBlock> buddyMap;  // Keyed by process ID
+  int usedBuddyMemory = 0;          // KB in allocated blocks
+  int buddyInternalFragmentation = 0;  // KB allocated beyond what processes requested
+
+  bool allocateBuddyMemory(Process* process);
+  void removeBuddyMemory(Process* process);
+  void freeBuddyBlock(int address, int order);
+  void showBuddyFreeBlocks();
 
-  const std::string backingStorePath = "backing_store"; // Path for backing store files
-  
+  const std::string backingStorePath = "backing_store"; // Directory holding the swap file
+  SwapDevice swapDevice;
+  std::function<void(Process*)> swapInHandler;
+  Tracer* tracer;
 
   void saveProcessToBackingStore(Process* process);
 };
\ No newline at end of file
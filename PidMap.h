@@ -0,0 +1,165 @@
+#ifndef PIDMAP_H
+#define PIDMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Flat open-addressing hash table keyed by process ID.
+// Entries sit inline in one array probed linearly, so a lookup is a multiply,
+// a shift and usually a single cache line. Deletion shifts later entries back
+// instead of leaving tombstones. Process IDs start at 1; key 0 marks an empty bucket.
+template <typename V>
+class PidMap {
+public:
+	explicit PidMap(size_t initialCapacity = 16) {
+		size_t capacity = 8;
+		while (capacity < initialCapacity) {
+			capacity <<= 1;
+		}
+		resize(capacity);
+	}
+
+	V* find(int pid) {
+		size_t index = indexOf(pid);
+		return index == notFound ? nullptr : &entries[index].value;
+	}
+
+	const V* find(int pid) const {
+		size_t index = indexOf(pid);
+		return index == notFound ? nullptr : &entries[index].value;
+	}
+
+	bool contains(int pid) const { return indexOf(pid) != notFound; }
+
+	// Inserts a default-constructed value if pid is missing
+	V& operator[](int pid) {
+		size_t index = indexOf(pid);
+		if (index != notFound) {
+			return entries[index].value;
+		}
+
+		if ((count + 1) * 2 > entries.size()) {
+			grow();
+		}
+		index = bucketFor(pid);
+		while (entries[index].key != 0) {
+			index = (index + 1) & mask;
+		}
+		entries[index].key = pid;
+		entries[index].value = V();
+		count++;
+		return entries[index].value;
+	}
+
+	bool erase(int pid) {
+		size_t hole = indexOf(pid);
+		if (hole == notFound) {
+			return false;
+		}
+
+		// Pull back every following entry whose home bucket is at or before the hole
+		size_t next = hole;
+		while (true) {
+			next = (next + 1) & mask;
+			if (entries[next].key == 0) {
+				break;
+			}
+			size_t home = bucketFor(entries[next].key);
+			if (((next - home) & mask) >= ((next - hole) & mask)) {
+				entries[hole] = std::move(entries[next]);
+				hole = next;
+			}
+		}
+		entries[hole].key = 0;
+		entries[hole].value = V();
+		count--;
+		return true;
+	}
+
+	void clear() {
+		for (Entry& entry : entries) {
+			entry.key = 0;
+			entry.value = V();
+		}
+		count = 0;
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	// Calls f(pid, value) for every entry, in no particular order
+	template <typename F>
+	void forEach(F&& f) {
+		for (Entry& entry : entries) {
+			if (entry.key != 0) {
+				f(entry.key, entry.value);
+			}
+		}
+	}
+
+	template <typename F>
+	void forEach(F&& f) const {
+		for (const Entry& entry : entries) {
+			if (entry.key != 0) {
+				f(entry.key, entry.value);
+			}
+		}
+	}
+
+private:
+	struct Entry {
+		int key = 0;
+		V value{};
+	};
+
+	static constexpr size_t notFound = ~size_t(0);
+
+	std::vector<Entry> entries;
+	size_t count = 0;
+	size_t mask = 0;
+	int shift = 0;
+
+	// Fibonacci hashing spreads consecutive IDs across the table
+	size_t bucketFor(int pid) const {
+		return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(pid)) * 0x9E3779B97F4A7C15ull) >> shift);
+	}
+
+	size_t indexOf(int pid) const {
+		if (pid == 0) {
+			return notFound;
+		}
+		for (size_t index = bucketFor(pid); entries[index].key != 0; index = (index + 1) & mask) {
+			if (entries[index].key == pid) {
+				return index;
+			}
+		}
+		return notFound;
+	}
+
+	void resize(size_t capacity) {
+		entries.assign(capacity, Entry());
+		mask = capacity - 1;
+		shift = 64;
+		for (size_t bits = capacity; bits > 1; bits >>= 1) {
+			shift--;
+		}
+	}
+
+	void grow() {
+		std::vector<Entry> old = std::move(entries);
+		resize(old.size() * 2);
+		for (Entry& entry : old) {
+			if (entry.key != 0) {
+				size_t index = bucketFor(entry.key);
+				while (entries[index].key != 0) {
+					index = (index + 1) & mask;
+				}
+				entries[index] = std::move(entry);
+			}
+		}
+	}
+};
+
+#endif // PIDMAP_H
@@ -2,46 +2,100 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
-#include <ctime>
 #include <fstream>
 #include <random>
+#include <algorithm>
 
 using namespace std;
 
 static int processCounter = 0; // Global process counter to assign unique IDs
 
+// Random instruction over the process's variable slots
+static Instruction generateInstruction(mt19937& gen) {
+    uniform_int_distribution<> opcodeDist(Instruction::PRINT, Instruction::SLEEP);
+    uniform_int_distribution<> variableDist(0, Instruction::maxVariables - 1);
+    uniform_int_distribution<> valueDist(0, 100);
+    uniform_int_distribution<> flagDist(0, 3);
+
+    Instruction instruction = {};
+    instruction.opcode = static_cast<uint8_t>(opcodeDist(gen));
+    instruction.dest = static_cast<uint16_t>(variableDist(gen));
+
+    switch (instruction.opcode) {
+        case Instruction::DECLARE:
+            instruction.flags = Instruction::IMMEDIATE1;
+            instruction.operand1 = static_cast<uint16_t>(valueDist(gen));
+            break;
+        case Instruction::ADD:
+        case Instruction::SUBTRACT:
+            // Each operand is independently a variable or a literal
+            instruction.flags = static_cast<uint8_t>(flagDist(gen));
+            instruction.operand1 = static_cast<uint16_t>((instruction.flags & Instruction::IMMEDIATE1) ? valueDist(gen) : variableDist(gen));
+            instruction.operand2 = static_cast<uint16_t>((instruction.flags & Instruction::IMMEDIATE2) ? valueDist(gen) : variableDist(gen));
+            break;
+        case Instruction::SLEEP:
+            instruction.flags = Instruction::IMMEDIATE1;
+            instruction.operand1 = static_cast<uint16_t>(uniform_int_distribution<>(1, 5)(gen));
+            break;
+        default:
+            break;
+    }
+    return instruction;
+}
+
+// CPU steps an instruction takes: one, plus the ticks a SLEEP waits
+static int stepCost(const Instruction& instruction) {
+    return instruction.opcode == Instruction::SLEEP ? 1 + instruction.operand1 : 1;
+}
+
+// Appends instructions, possibly with nested FOR loops, that take exactly budget steps
+static void generateBlock(vector<Instruction>& program, int budget, int depth, mt19937& gen) {
+    uniform_int_distribution<> loopChance(0, 9);
+
+    while (budget > 0) {
+        if (depth < Instruction::maxLoopDepth && budget >= 2 && loopChance(gen) == 0) {
+            int repeats = min(uniform_int_distribution<>(2, 3)(gen), budget);
+            int bodyCost = uniform_int_distribution<>(1, min(budget / repeats, 8))(gen);
+
+            program.push_back({ Instruction::FOR, Instruction::IMMEDIATE1, 0, static_cast<uint16_t>(repeats), 0 });
+            generateBlock(program, bodyCost, depth + 1, gen);
+            program.push_back({ Instruction::END_FOR, 0, 0, 0, 0 });
+            budget -= repeats * bodyCost;
+            continue;
+        }
+
+        Instruction instruction = generateInstruction(gen);
+        if (instruction.opcode == Instruction::SLEEP) {
+            instruction.operand1 = static_cast<uint16_t>(min<int>(instruction.operand1, budget - 1));
+        }
+        program.push_back(instruction);
+        budget -= stepCost(instruction);
+    }
+}
+
 Process::Process(string name, int minCommands, int maxCommands, int minSize, int maxSize, int memPerFrame)
-    : processName(name), processId(++processCounter), commandIndex(0), isActive(true), status(READY), coreIndex(-1), runTimestamp() {
+    : state(encodeState(READY, 0, -1)), processName(name), processId(++processCounter), creationTime(Timestamp::now()), isActive(true) {
     
-    // Seed the random number generator
-    random_device rd;
-    mt19937 gen(rd()); // Mersenne Twister engine for randomness
+    // One generator per thread; seeding from random_device for every process is slow
+    static thread_local mt19937 gen(random_device{}()); // Mersenne Twister engine for randomness
     uniform_int_distribution<> dist(minCommands, maxCommands);
 
-    // Generate a random number of commands between minCommands and maxCommands
+    // Generate a program that runs for between minCommands and maxCommands steps
     int numCommands = dist(gen);
-
-    // Fill the commands vector with "dummy instruction" strings
-    for (int i = 1; i <= numCommands; ++i) {
-        commands.push_back("dummy instruction " + to_string(i));
-    }
+    generateBlock(instructions, numCommands, 0, gen);
+    instructions.shrink_to_fit();
+    totalSteps = numCommands;
 
 		// Generate a random memory size between minSize and maxSize
 		uniform_int_distribution<> distSize(minSize, maxSize);
-    memorySize = minSize;
-		numPages = distSize(gen) / memPerFrame;
-
-    time_t now = time(0);
-    tm localtm;
-    localtime_s(&localtm, &now);  // Use thread-safe localtime_s
-    char timestamp[100];
-    strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S%p)", &localtm);
-	  creationTimestamp = string(timestamp);  // Store the formatted timestamp
+    memorySize = distSize(gen);
+		numPages = (memorySize + memPerFrame - 1) / memPerFrame;
 }
 
 void Process::displayDetails() const {
     string statusString;
-    switch (status) {
+    Snapshot current = snapshot();
+    switch (current.status) {
 	    case WAITING: statusString = "Waiting"; break;
         case READY: statusString = "Ready"; break;
         case RUNNING: statusString = "Running"; break;
@@ -50,46 +104,138 @@ void Process::displayDetails() const {
 
     cout << endl << "   Process: " << processName << endl;
     cout << "   ID: " << processId << endl;
-    cout << "   Core: " << coreIndex << endl;
-    cout << "   Current instruction line: " << commandIndex << " / " << commands.size() << endl;
-    cout << "   Run at: " << runTimestamp << endl;
+    cout << "   Core: " << current.coreIndex << endl;
+    cout << "   Nice: " << nice << endl;
+    cout << "   Current instruction line: " << current.commandIndex << " / " << totalSteps << endl;
+    cout << "   Footprint: " << getMemoryFootprint() << " bytes" << endl;
+    cout << "   Run at: " << getRunTimestamp() << endl;
     cout << "   Status: " << statusString << endl << endl;
 }
 
+void Process::setNice(int value) {
+    nice = std::clamp(value, -20, 19);
+}
+
 void Process::setTimestamp() {
-    // Capture the current time as the start timestamp
-    time_t now = time(0);
-    tm localtm;
-    localtime_s(&localtm, &now);  // Use thread-safe localtime_s
-    char timestamp[100];
-    strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S%p)", &localtm);
-    runTimestamp = string(timestamp);  // Store the formatted timestamp
+    // Runs on every dispatch, so only the raw clock is read here; formatting waits for display
+    runTime.store(Timestamp::now(), std::memory_order_relaxed);
 }
 
 void Process::getNextCommand() {
-    if (commandIndex < commands.size()-1) {
-        commandIndex++;
+    // Only the core running the process advances it, so a plain load/store pair is enough
+    uint64_t word = state.load(std::memory_order_relaxed);
+    int commandIndex = decodeCommandIndex(word);
+    if (static_cast<size_t>(commandIndex) + 1 < totalSteps) {
+        state.store(encodeState(decodeStatus(word), commandIndex + 1, decodeCoreIndex(word)), std::memory_order_release);
     }
     else {
         setStatus(FINISHED);
     }
 }
 
+void Process::setStatus(Status newStatus) {
+    uint64_t word = state.load(std::memory_order_relaxed);
+    while (!state.compare_exchange_weak(word, encodeState(newStatus, decodeCommandIndex(word), decodeCoreIndex(word)),
+        std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void Process::setCoreIndex(int core) {
+    uint64_t word = state.load(std::memory_order_relaxed);
+    while (!state.compare_exchange_weak(word, encodeState(decodeStatus(word), decodeCommandIndex(word), core),
+        std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+Process::Snapshot Process::snapshot() const {
+    uint64_t word = state.load(std::memory_order_acquire);
+    return { decodeStatus(word), decodeCommandIndex(word), decodeCoreIndex(word), runTime.load(std::memory_order_relaxed) };
+}
+
+int Process::getCurrentPage() const {
+    // Instructions are laid out evenly across the process's pages
+    if (instructions.empty()) {
+        return 0;
+    }
+    return static_cast<int>(static_cast<long long>(min<size_t>(programCounter, instructions.size() - 1)) * numPages / instructions.size());
+}
+
+size_t Process::getMemoryFootprint() const {
+    // Strings short enough for the small-string buffer don't allocate
+    auto heapBytes = [](const string& text) {
+        return text.capacity() > 15 ? text.capacity() + 1 : 0;
+    };
+    return sizeof(Process) + instructions.capacity() * sizeof(Instruction)
+        + heapBytes(processName);
+}
+
 void Process::execute() {
-    // commands[commandIndex];
+    // A sleeping process spends its steps waiting
+    if (sleepTicksRemaining > 0) {
+        sleepTicksRemaining--;
+        return;
+    }
+
+    // Loop control falls through to the next instruction that does real work
+    while (programCounter < instructions.size()) {
+        const Instruction& instruction = instructions[programCounter];
+        uint16_t first = (instruction.flags & Instruction::IMMEDIATE1) ? instruction.operand1 : variables[instruction.operand1 % Instruction::maxVariables];
+        uint16_t second = (instruction.flags & Instruction::IMMEDIATE2) ? instruction.operand2 : variables[instruction.operand2 % Instruction::maxVariables];
+
+        switch (instruction.opcode) {
+            case Instruction::FOR:
+                loopStack[loopDepth++] = { programCounter + 1, instruction.operand1 };
+                programCounter++;
+                continue;
+            case Instruction::END_FOR: {
+                LoopFrame& loop = loopStack[loopDepth - 1];
+                if (--loop.remaining > 0) {
+                    programCounter = loop.bodyStart;
+                }
+                else {
+                    loopDepth--;
+                    programCounter++;
+                }
+                continue;
+            }
+            case Instruction::PRINT:
+                lastPrintedValue = variables[instruction.dest];
+                printCount++;
+                break;
+            case Instruction::DECLARE:
+                variables[instruction.dest] = first;
+                break;
+            case Instruction::ADD:
+                // Arithmetic saturates at the uint16 bounds
+                variables[instruction.dest] = static_cast<uint16_t>(min<uint32_t>(uint32_t(first) + second, UINT16_MAX));
+                break;
+            case Instruction::SUBTRACT:
+                variables[instruction.dest] = first > second ? first - second : 0;
+                break;
+            case Instruction::SLEEP:
+                sleepTicksRemaining = first;
+                break;
+        }
+        programCounter++;
+        return;
+    }
 }
 
 void Process::processSMI() {
     cout << endl;
     cout << "Process: " << processName << endl;
-    cout << "ID: " << processId << endl << endl;
+    cout << "ID: " << processId << endl;
+    cout << "Nice: " << nice << endl << endl;
     
-    if (status == FINISHED) {
+    Snapshot current = snapshot();
+    if (current.status == FINISHED) {
         cout << "Finished!" << endl << endl;
     }
     else {
-        cout << "Current instruction line: " << commandIndex+1 << endl;
-        cout << "Lines of code: " << commands.size() << endl << endl;
+        cout << "Current instruction line: " << current.commandIndex+1 << endl;
+        cout << "Lines of code: " << totalSteps << endl;
+        cout << "PRINT output: " << printCount << " lines, last value " << lastPrintedValue << endl;
+        cout << "Footprint: " << getMemoryFootprint() << " bytes" << endl << endl;
     }
 
 }
\ No newline at end of file
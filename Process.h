@@ -3,10 +3,24 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <atomic>
+#include "Instruction.h"
+#include "Timestamp.h"
 
 using namespace std;
 
+// Generation-checked reference to a Process owned by the ProcessPool
+struct ProcessHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;  // 0 never names a live process
+
+    bool operator==(const ProcessHandle& other) const = default;
+};
+
 class Process {
+    friend class ProcessPool;
+
 public:
     // Constructor
     Process(string name, int minCommands, int maxCommands, int minSize, int maxSize, int memPerFrame);
@@ -14,6 +28,14 @@ public:
 
     // Enum for process status
     enum Status { WAITING, READY, RUNNING, FINISHED };
+
+    // Mutable scheduling state read together, so monitors never see a torn view
+    struct Snapshot {
+        Status status;
+        int commandIndex;
+        int coreIndex;
+        long long runTime;
+    };
     
     // Public methods
     void displayDetails() const;
@@ -21,38 +43,79 @@ public:
     void getNextCommand();
     void execute();
     void setTimestamp();
-    void setCoreIndex(int core) { coreIndex = core; }
-    void setStatus(Status newStatus) { status = newStatus; }
+    void setCoreIndex(int core);
+    void setStatus(Status newStatus);
+    void setPriorityLevel(int level) { priorityLevel = level; }  // Changed only by the scheduler, under schedulerMutex
+    void setNice(int value);  // Clamped to -20..19, set before the process is first queued
+    void setVruntime(unsigned long long value) { vruntime = value; }  // Changed only by the scheduler, under schedulerMutex
+    void setChargedSteps(int steps) { chargedSteps = steps; }
+    Snapshot snapshot() const;  // Safe to call while a core is running the process
 
 	// Getters
 	string getProcessName() const { return processName; }
+	ProcessHandle getHandle() const { return handle; }
 	int getProcessId() const { return processId; }
-	Status getStatus() const { return status; }
+	Status getStatus() const { return decodeStatus(state.load(std::memory_order_acquire)); }
 	bool getIsActive() const { return isActive; }
-	size_t getTotalCommands() const { return commands.size(); }
-  int getCommandIndex() const { return commandIndex; }
-	int getCoreIndex() const { return coreIndex; }
-	string getCreationTimestamp() const { return creationTimestamp; }
-	string getRunTimestamp() const { return runTimestamp; }
+	size_t getTotalCommands() const { return totalSteps; }
+	size_t getRemainingCommands() const { return totalSteps - getCommandIndex(); }  // Steps left, the SJF/SRTF key
+  int getCommandIndex() const { return decodeCommandIndex(state.load(std::memory_order_acquire)); }
+	uint16_t getVariable(int slot) const { return variables[slot]; }
+	int getCoreIndex() const { return decodeCoreIndex(state.load(std::memory_order_acquire)); }
+	int getPriorityLevel() const { return priorityLevel; }
+	int getNice() const { return nice; }
+	unsigned long long getVruntime() const { return vruntime; }
+	int getChargedSteps() const { return chargedSteps; }
+	string getCreationTimestamp() const { return Timestamp::format(creationTime); }  // Formatted on demand
+	string getRunTimestamp() const { return Timestamp::format(runTime.load(std::memory_order_relaxed)); }
 	int getMemorySize() const { return memorySize; }
 	int getNumPages() const { return numPages; }
+	int getCurrentPage() const;  // Page holding the instruction at commandIndex
+	size_t getMemoryFootprint() const;  // Host bytes used by this process object and its heap data
 
 	
 
 
 private:
     // Private member variables
-    Status status;            // Process status
+    // Status (bits 0-7), core index + 1 (bits 8-23) and steps executed (bits 32-63) in one word.
+    // Workers update it with a single atomic store, so readers need no lock.
+    std::atomic<uint64_t> state;
     string processName;        // Name of the process
     int processId;             // Unique ID for the process
-    vector<string> commands;   // List of commands for the process
-    int commandIndex;          // Current command being executed
-	string creationTimestamp;  // Timestamp when the process was created
-    string runTimestamp;       // Timestamp when the process starts running
+    ProcessHandle handle;      // Set by the ProcessPool that owns this process
+    vector<Instruction> instructions;  // Pre-decoded program, 8 bytes per instruction
+    size_t totalSteps = 0;     // CPU steps the program takes with loops unrolled and sleeps counted
+
+    // Interpreter state
+    struct LoopFrame {
+        uint32_t bodyStart;    // Instruction after the FOR
+        uint16_t remaining;    // Iterations left, including the current one
+    };
+    uint32_t programCounter = 0;
+    uint16_t sleepTicksRemaining = 0;
+    uint8_t loopDepth = 0;
+    LoopFrame loopStack[Instruction::maxLoopDepth];
+    uint16_t variables[Instruction::maxVariables] = {};  // Variable slots, held on the process's page 0
+    uint16_t lastPrintedValue = 0;
+    int printCount = 0;
+    int priorityLevel = 0;     // MLFQ queue level, 0 is the highest priority
+    int nice = 0;              // CFS weight selector, -20 (heaviest) to 19 (lightest)
+    unsigned long long vruntime = 0;  // CFS virtual runtime in 1/1024 steps, scaled by weight
+    int chargedSteps = 0;      // Steps already added to vruntime
+	long long creationTime;    // Steady-clock ns when the process was created
+    std::atomic<long long> runTime{ 0 };  // Steady-clock ns when the process last started running, 0 if never
     bool isActive;             // Indicates if the process is active
-    int coreIndex;             // The core index the process is assigned to
     int memorySize; 
     int numPages;
+
+    static uint64_t encodeState(Status status, int commandIndex, int coreIndex) {
+        return static_cast<uint64_t>(status) | (static_cast<uint64_t>(static_cast<uint16_t>(coreIndex + 1)) << 8)
+            | (static_cast<uint64_t>(static_cast<uint32_t>(commandIndex)) << 32);
+    }
+    static Status decodeStatus(uint64_t word) { return static_cast<Status>(word & 0xFF); }
+    static int decodeCoreIndex(uint64_t word) { return static_cast<int>((word >> 8) & 0xFFFF) - 1; }
+    static int decodeCommandIndex(uint64_t word) { return static_cast<int>(word >> 32); }
 };
 
 #endif // PROCESS_H
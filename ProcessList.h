@@ -0,0 +1,58 @@
+#ifndef PROCESSLIST_H
+#define PROCESSLIST_H
+
+#include "Process.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Append-only list of process handles in creation order.
+// Entries live in fixed chunks that never move, and the count is published only
+// after an entry is written, so readers walk the list without any lock while a
+// single writer (serialized by the caller) keeps appending.
+class ProcessList {
+public:
+	ProcessList() = default;
+	~ProcessList() {
+		for (auto& chunk : chunks) {
+			delete[] chunk.load();
+		}
+	}
+
+	ProcessList(const ProcessList&) = delete;
+	ProcessList& operator=(const ProcessList&) = delete;
+
+	// Returns false once the list is full
+	bool append(ProcessHandle handle) {
+		size_t index = count.load(std::memory_order_relaxed);
+		if (index / chunkSize >= maxChunks) {
+			return false;
+		}
+		if (index % chunkSize == 0) {
+			chunks[index / chunkSize].store(new ProcessHandle[chunkSize], std::memory_order_relaxed);
+		}
+		chunks[index / chunkSize].load(std::memory_order_relaxed)[index % chunkSize] = handle;
+		count.store(index + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t size() const { return count.load(std::memory_order_acquire); }
+
+	// Calls f(handle) for every entry published when the walk started
+	template <typename F>
+	void forEach(F&& f) const {
+		size_t published = size();
+		for (size_t index = 0; index < published; index++) {
+			f(chunks[index / chunkSize].load(std::memory_order_relaxed)[index % chunkSize]);
+		}
+	}
+
+private:
+	static constexpr size_t chunkSize = 4096;
+	static constexpr size_t maxChunks = 1024;  // Matches the ProcessPool's ~4M process limit
+
+	std::array<std::atomic<ProcessHandle*>, maxChunks> chunks{};
+	std::atomic<size_t> count{ 0 };
+};
+
+#endif // PROCESSLIST_H
@@ -0,0 +1,42 @@
+#include "ProcessPool.h"
+
+using namespace std;
+
+ProcessPool::~ProcessPool() {
+	for (size_t index = 0; index < slotCount; index++) {
+		Slot& slot = slotAt(static_cast<uint32_t>(index));
+		if (slot.live) {
+			std::launder(reinterpret_cast<Process*>(slot.storage))->~Process();
+		}
+	}
+	for (auto& chunk : chunks) {
+		delete chunk.load();
+	}
+}
+
+Process* ProcessPool::get(ProcessHandle handle) const {
+	if (handle.generation == 0 || handle.index >= slotCount.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	Slot& slot = slotAt(handle.index);
+	if (!slot.live.load(std::memory_order_acquire) || slot.generation.load(std::memory_order_relaxed) != handle.generation) {
+		return nullptr;
+	}
+	return std::launder(reinterpret_cast<Process*>(slot.storage));
+}
+
+bool ProcessPool::release(ProcessHandle handle) {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	Process* process = get(handle);
+	if (process == nullptr) {
+		return false;
+	}
+
+	Slot& slot = slotAt(handle.index);
+	slot.live.store(false, std::memory_order_release);
+	process->~Process();
+	freeSlots.push_back(handle.index);
+	liveCount--;
+	return true;
+}
@@ -0,0 +1,88 @@
+#ifndef PROCESSPOOL_H
+#define PROCESSPOOL_H
+
+#include "Process.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Slab arena that owns every Process.
+// Processes live in fixed-size chunks that are never moved or freed until the
+// pool is destroyed, so lookups need no lock. Callers hold ProcessHandles; a
+// handle whose slot has been released and reused fails the generation check
+// in get() instead of reaching the new occupant.
+class ProcessPool {
+public:
+	ProcessPool() = default;
+	~ProcessPool();
+
+	ProcessPool(const ProcessPool&) = delete;
+	ProcessPool& operator=(const ProcessPool&) = delete;
+
+	// Constructs a Process in a free slot, reusing released slots first
+	template <typename... Args>
+	ProcessHandle create(Args&&... args) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		uint32_t index;
+		if (!freeSlots.empty()) {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(slotCount);
+			if (index % chunkSize == 0) {
+				if (index / chunkSize >= maxChunks) {
+					return {};  // Pool exhausted
+				}
+				chunks[index / chunkSize].store(new Chunk(), std::memory_order_release);
+			}
+			slotCount++;
+		}
+
+		Slot& slot = slotAt(index);
+		uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+		Process* process = new (slot.storage) Process(std::forward<Args>(args)...);
+		process->handle = { index, generation };
+		slot.generation.store(generation, std::memory_order_relaxed);
+		slot.live.store(true, std::memory_order_release);
+		liveCount++;
+		return process->handle;
+	}
+
+	Process* get(ProcessHandle handle) const;  // nullptr if the handle is stale or empty
+	bool release(ProcessHandle handle);         // Destroys the process and recycles its slot
+
+	size_t size() const { return liveCount; }
+	size_t capacity() const { return slotCount; }
+
+private:
+	static constexpr size_t chunkSize = 1024;
+	static constexpr size_t maxChunks = 4096;  // Up to ~4M processes
+
+	struct Slot {
+		alignas(Process) unsigned char storage[sizeof(Process)];
+		std::atomic<uint32_t> generation{ 0 };  // Bumped on every create; handles must match it
+		std::atomic<bool> live{ false };
+	};
+
+	struct Chunk {
+		Slot slots[chunkSize];
+	};
+
+	std::array<std::atomic<Chunk*>, maxChunks> chunks{};
+	std::mutex poolMutex;            // Serializes create and release
+	std::vector<uint32_t> freeSlots; // Released slots, reused first
+	std::atomic<size_t> slotCount{ 0 };
+	std::atomic<size_t> liveCount{ 0 };
+
+	Slot& slotAt(uint32_t index) const {
+		return chunks[index / chunkSize].load(std::memory_order_acquire)->slots[index % chunkSize];
+	}
+};
+
+#endif // PROCESSPOOL_H
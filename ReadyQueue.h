@@ -0,0 +1,147 @@
+#ifndef READYQUEUE_H
+#define READYQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+// Bounded lock-free multi-producer/multi-consumer queue.
+// Every cell carries a sequence number that tells producers and consumers
+// whether it is free for the position they claimed, so push and pop only
+// need a CAS on the shared head/tail counters.
+template <typename T>
+class ReadyQueue {
+public:
+	// Capacity is rounded up to a power of two
+	explicit ReadyQueue(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		mask = size - 1;
+		cells = std::make_unique<Cell[]>(size);
+		for (size_t i = 0; i < size; i++) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	ReadyQueue(const ReadyQueue&) = delete;
+	ReadyQueue& operator=(const ReadyQueue&) = delete;
+
+	// Returns false if the queue is full
+	bool tryPush(const T& item) {
+		return tryPushBatch(&item, 1) == 1;
+	}
+
+	// Blocks (yielding) while the queue is full
+	void push(const T& item) {
+		while (!tryPush(item)) {
+			std::this_thread::yield();
+		}
+	}
+
+	// Claims up to count consecutive cells with one CAS; returns how many were pushed
+	size_t tryPushBatch(const T* items, size_t count) {
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		while (true) {
+			size_t available = 0;
+			while (available < count) {
+				Cell& cell = cells[(pos + available) & mask];
+				if (cell.sequence.load(std::memory_order_acquire) != pos + available) {
+					break;
+				}
+				available++;
+			}
+
+			if (available == 0) {
+				Cell& cell = cells[pos & mask];
+				if (static_cast<ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - pos) < 0) {
+					return 0; // Full
+				}
+				pos = enqueuePos.load(std::memory_order_relaxed); // Another producer moved ahead
+				continue;
+			}
+
+			if (enqueuePos.compare_exchange_weak(pos, pos + available, std::memory_order_relaxed)) {
+				for (size_t i = 0; i < available; i++) {
+					Cell& cell = cells[(pos + i) & mask];
+					cell.data = items[i];
+					cell.sequence.store(pos + i + 1, std::memory_order_release);
+				}
+				return available;
+			}
+		}
+	}
+
+	// Blocks (yielding) until every item has been pushed
+	void pushBatch(const T* items, size_t count) {
+		while (count > 0) {
+			size_t pushed = tryPushBatch(items, count);
+			items += pushed;
+			count -= pushed;
+			if (count > 0) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool tryPop(T& item) {
+		return tryPopBatch(&item, 1) == 1;
+	}
+
+	// Claims up to maxCount consecutive items with one CAS; returns how many were popped
+	size_t tryPopBatch(T* out, size_t maxCount) {
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		while (true) {
+			size_t available = 0;
+			while (available < maxCount) {
+				Cell& cell = cells[(pos + available) & mask];
+				if (cell.sequence.load(std::memory_order_acquire) != pos + available + 1) {
+					break;
+				}
+				available++;
+			}
+
+			if (available == 0) {
+				Cell& cell = cells[pos & mask];
+				if (static_cast<ptrdiff_t>(cell.sequence.load(std::memory_order_acquire) - (pos + 1)) < 0) {
+					return 0; // Empty
+				}
+				pos = dequeuePos.load(std::memory_order_relaxed); // Another consumer moved ahead
+				continue;
+			}
+
+			if (dequeuePos.compare_exchange_weak(pos, pos + available, std::memory_order_relaxed)) {
+				for (size_t i = 0; i < available; i++) {
+					Cell& cell = cells[(pos + i) & mask];
+					out[i] = cell.data;
+					cell.sequence.store(pos + i + mask + 1, std::memory_order_release);
+				}
+				return available;
+			}
+		}
+	}
+
+	// Approximate when producers or consumers are active
+	bool empty() const {
+		return enqueuePos.load(std::memory_order_acquire) == dequeuePos.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const { return mask + 1; }
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+
+	// Producer and consumer counters live on separate cache lines
+	alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+};
+
+#endif // READYQUEUE_H
@@ -1,46 +1,270 @@
 #include "Scheduler.h"
 #include "ConfigManager.h"
+#include "Simulator.h"
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <limits>
 
-Scheduler::Scheduler(ConfigManager* config, MemoryAllocator* resManager) {
+// Slots in the lock-free arrivals queue; producers yield while it is full
+static constexpr size_t readyQueueCapacity = 1 << 16;
+
+// Wall-clock length of one CPU tick in realtime mode
+static constexpr std::chrono::milliseconds tickPeriod(20);
+
+// CFS weight for nice -20..19, the Linux table: each nice step is worth about 10% of CPU share
+static constexpr unsigned long long niceWeights[40] = {
+	88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+	9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+	1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+	110, 87, 70, 56, 45, 36, 29, 23, 18, 15
+};
+static constexpr unsigned long long nice0Weight = 1024;
+
+Scheduler::Scheduler(ConfigManager* config, MemoryAllocator* resManager, ProcessPool* pool, Tracer* eventTracer)
+	: arrivals(readyQueueCapacity) {
 	memAllocator = resManager;
-	cpuCores.resize(config->getNumCpu(), false);
+	processPool = pool;
+	tracer = eventTracer;
 	quantumCycles = config->getQuantumCycles();
 	delayPerExec = config->getDelayPerExec();
 	batchProcessFreq = config->getBatchProcessFreq();
 	schedulerType = config->getSchedulerType();
+	mlfqLevels = config->getMlfqLevels();
+	mlfqBoostTicks = config->getMlfqBoostTicks();
+	levelQueues.resize(mlfqLevels);
+	levelDepths = std::make_unique<std::atomic<size_t>[]>(mlfqLevels);
+
+	if (config->getExecutionMode() == ConfigManager::ExecutionMode::SIMULATE) {
+		simulator = new Simulator(this);
+		// Trace virtual time, one tick per microsecond, since the simulation runs far ahead of the wall clock
+		tracer->setClock([this] { return static_cast<long long>(simulator->getCurrentTick()) * 1000; });
+	}
+	else {
+		cpuClock = new CpuClock(tickPeriod);
+	}
+
+	for (int i = 0; i < config->getNumCpu(); i++) {
+		cores.push_back(std::make_unique<CoreState>());
+		cores[i]->counters.idleSinceTick = currentTick();
+	}
+
+	if (simulator != nullptr) {
+		// Virtual time only advances through advanceTo; no threads run
+		return;
+	}
+
+	// Swap-ins finish on the swap I/O thread and hand the process back here
+	memAllocator->setSwapInHandler([this](Process* process) { swapInComplete(process); });
+
+	cpuClock->start();
+
+	// Spawn one long-lived worker per emulated core
+	for (int i = 0; i < config->getNumCpu(); i++) {
+		if (schedulerType == ConfigManager::SchedulerType::RR_WS) {
+			cores[i]->worker = std::thread(&Scheduler::wsWorker, this, i);
+		}
+		else {
+			cores[i]->worker = std::thread(&Scheduler::coreWorker, this, i);
+		}
+	}
+
 	this->start();  // Start the scheduler loop
 	
 }
 
 Scheduler::~Scheduler() {
-    
+	stop();
+	delete simulator;
+	delete cpuClock;
 }
 
-void Scheduler::start() {
-	if (schedulerType == ConfigManager::SchedulerType::FCFS) {
-		std::thread schedulerThread(&Scheduler::fcfsLoop, this);
-		schedulerThread.detach();
+void Scheduler::stop() {
+	memAllocator->setSwapInHandler(nullptr);
+	// Stopping the clock first lets workers run out their current slices without waiting on ticks
+	if (cpuClock != nullptr) {
+		cpuClock->stop();
 	}
-	else if (schedulerType == ConfigManager::SchedulerType::RR) {
-		std::thread schedulerThread(&Scheduler::rrLoop, this);
-		schedulerThread.detach();
+	{
+		std::lock_guard<std::mutex> lock(schedulerMutex);
+		stopScheduler = true;
 	}
-	else {
+	dispatchCv.notify_one();
+	wakeWorkers(true);
+	if (dispatcherThread.joinable()) {
+		dispatcherThread.join();
+	}
+	for (auto& core : cores) {
+		core->slotCv.notify_one();
+		if (core->worker.joinable()) {
+			core->worker.join();
+		}
+	}
+}
+
+void Scheduler::start() {
+	if (schedulerType == ConfigManager::SchedulerType::RR_WS) {
+		// Workers pull from their own queues; no central dispatcher needed
+		return;
+	}
+	if (schedulerType != ConfigManager::SchedulerType::FCFS && schedulerType != ConfigManager::SchedulerType::RR
+		&& schedulerType != ConfigManager::SchedulerType::MLFQ && schedulerType != ConfigManager::SchedulerType::CFS
+		&& !usesShortestQueue()) {
 		std::cerr << "Invalid scheduler type: " << schedulerType << std::endl;
 		return;
 	}
+	dispatcherThread = std::thread(&Scheduler::dispatcherLoop, this);
 }
 
-void Scheduler::addProcess(Process* newProcess) {
-	readyQueue.push(newProcess);
+void Scheduler::addProcess(ProcessHandle newProcess) {
+	if (schedulerType == ConfigManager::SchedulerType::RR_WS) {
+		// Spread new arrivals across the per-core queues
+		Process* process = processPool->get(newProcess);
+		if (process != nullptr) {
+			pushLocal(nextCore++ % cores.size(), process);
+		}
+		return;
+	}
+	arrivals.push(newProcess);
+	wakeDispatcher();
+}
+
+void Scheduler::wakeDispatcher() {
+	// Only take the lock when the dispatcher is actually parked on dispatchCv. The fence pairs with
+	// the one in dispatcherLoop: either this sees the flag set, or the dispatcher sees the push.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (dispatcherSleeping.exchange(false)) {
+		std::lock_guard<std::mutex> lock(schedulerMutex);
+		dispatchCv.notify_one();
+	}
+}
+
+void Scheduler::drainArrivals() {
+	// Caller holds schedulerMutex
+	ProcessHandle batch[64];
+	size_t count;
+	while ((count = arrivals.tryPopBatch(batch, 64)) > 0) {
+		for (size_t i = 0; i < count; i++) {
+			// A handle reaped before it was dispatched no longer resolves
+			Process* process = processPool->get(batch[i]);
+			if (process != nullptr) {
+				enqueueReady(process);
+			}
+		}
+	}
+}
+
+void Scheduler::enqueueReady(Process* process) {
+	// Caller holds schedulerMutex
+	if (usesShortestQueue()) {
+		shortestQueue.push({ process->getRemainingCommands(), nextShortestSequence++, process, false });
+	}
+	else if (schedulerType == ConfigManager::SchedulerType::MLFQ) {
+		int level = process->getPriorityLevel();
+		levelQueues[level].push_back(process);
+		publishLevelDepth(level);
+	}
+	else if (schedulerType == ConfigManager::SchedulerType::CFS) {
+		// New and swapped-in processes keep their own vruntime unless it has fallen behind the queue
+		unsigned long long vruntime = std::max(process->getVruntime(), minVruntime.load(std::memory_order_relaxed));
+		process->setVruntime(vruntime);
+		fairQueue.insert({ vruntime, nextFairSequence++, process });
+		publishFairDepth();
+	}
+	else {
+		readyQueue.push(process);
+	}
+}
+
+bool Scheduler::usesShortestQueue() const {
+	return schedulerType == ConfigManager::SchedulerType::SJF || schedulerType == ConfigManager::SchedulerType::SRTF;
+}
+
+unsigned long long Scheduler::quantumFor(Process* process) const {
+	switch (schedulerType) {
+		case ConfigManager::SchedulerType::RR:
+		case ConfigManager::SchedulerType::RR_WS:
+		case ConfigManager::SchedulerType::CFS:
+			return quantumCycles;  // CFS weights act through vruntime, which decides how often a process runs
+		case ConfigManager::SchedulerType::MLFQ:
+			// The quantum doubles with each level down
+			return static_cast<unsigned long long>(quantumCycles) << process->getPriorityLevel();
+		default:
+			// FCFS and SJF run to completion; SRTF runs until a shorter process preempts it
+			return 0;
+	}
+}
+
+void Scheduler::notifyDispatcher() {
+	// Caller holds schedulerMutex
+	schedulerEvents++;
+	dispatchCv.notify_one();
+}
+
+CpuStats Scheduler::getCpuStats() {
+	// Spans are accumulated when a core changes state; add the ones still in progress
+	unsigned long long now = currentTick();
+	CpuStats stats;
+	for (auto& core : cores) {
+		const CoreCounters& counters = core->counters;
+		stats.activeTicks += counters.activeTicks.load(std::memory_order_relaxed);
+		stats.idleTicks += counters.idleTicks.load(std::memory_order_relaxed);
+		stats.dispatches += counters.dispatches.load(std::memory_order_relaxed);
+		stats.preemptions += counters.preemptions.load(std::memory_order_relaxed);
+		stats.swapWaitTicks += counters.swapWaitTicks.load(std::memory_order_relaxed);
+		if (core->busy) {
+			stats.activeTicks += now - counters.busySinceTick.load(std::memory_order_relaxed);
+		}
+		else {
+			stats.idleTicks += now - counters.idleSinceTick.load(std::memory_order_relaxed);
+		}
+	}
+	return stats;
+}
+
+unsigned long long Scheduler::getIdleCpuTicks() {
+	return getCpuStats().idleTicks;
+}
+
+unsigned long long Scheduler::getActiveCpuTicks() {
+	return getCpuStats().activeTicks;
+}
+
+unsigned long long Scheduler::currentTick() {
+	if (simulator != nullptr) {
+		return simulator->getCurrentTick();
+	}
+	return cpuClock->getTick();
+}
+
+unsigned long long Scheduler::getSimulatedTick() {
+	return simulator != nullptr ? simulator->getCurrentTick() : 0;
+}
+
+void Scheduler::advanceTo(unsigned long long tick) {
+	if (simulator != nullptr) {
+		simulator->runUntil(tick);
+	}
 }
 
 Scheduler::CpuUtilization Scheduler::getCpuUtilization() {
-	int availableCpuCores = std::count(cpuCores.begin(), cpuCores.end(), false);
-	double utilization = (static_cast<double>(cpuCores.size()) - availableCpuCores) / static_cast<double>(cpuCores.size()) * 100;
-	return { utilization, availableCpuCores, static_cast<int>(cpuCores.size()) - availableCpuCores };
+	int totalCores = static_cast<int>(cores.size());
+	int availableCpuCores = 0;
+	for (auto& core : cores) {
+		if (!core->busy) {
+			availableCpuCores++;
+		}
+	}
+	double utilization = (static_cast<double>(totalCores) - availableCpuCores) / static_cast<double>(totalCores) * 100;
+	return { utilization, availableCpuCores, totalCores - availableCpuCores };
+}
+
+std::vector<bool> Scheduler::getCpuCores() {
+	std::vector<bool> cpuCores;
+	for (auto& core : cores) {
+		cpuCores.push_back(core->busy);
+	}
+	return cpuCores;
 }
 
 void Scheduler::displayCpuUtilization() {
@@ -49,137 +273,708 @@ void Scheduler::displayCpuUtilization() {
 	cout << "CPU utilization: " << util.utilization << "%" << endl;
 	cout << "Cores used: " << util.usedCores << endl;
 	cout << "Cores available: " << util.availableCores << endl << endl;
+
+	if (schedulerType == ConfigManager::SchedulerType::RR_WS) {
+		cout << "Steals: " << getStealCount() << endl;
+		cout << "Migrations: " << getMigrationCount() << endl << endl;
+	}
+
+	if (schedulerType == ConfigManager::SchedulerType::MLFQ) {
+		for (int level = 0; level < mlfqLevels; level++) {
+			cout << "Level " << level << " (quantum " << (static_cast<unsigned long long>(quantumCycles) << level) << "): "
+				<< levelDepths[level].load(std::memory_order_relaxed) << " queued" << endl;
+		}
+		cout << "Waiting for memory: " << levelParkedDepth.load(std::memory_order_relaxed) << endl;
+		cout << "Demotions: " << demotionCount << "   Boosts: " << boostCount << endl << endl;
+	}
+
+	if (schedulerType == ConfigManager::SchedulerType::CFS) {
+		cout << "Runnable: " << fairDepth.load(std::memory_order_relaxed)
+			<< " (" << fairParkedDepth.load(std::memory_order_relaxed) << " waiting for memory)"
+			<< "   Min vruntime: " << minVruntime.load(std::memory_order_relaxed) / 1024 << endl << endl;
+	}
 }
 
-void Scheduler::fcfsLoop() {
-	while(true){
+void Scheduler::markCoreBusy(int coreIndex, Process* process) {
+	CoreCounters& counters = cores[coreIndex]->counters;
+	unsigned long long now = currentTick();
+	CoreCounters::add(counters.idleTicks, now - counters.idleSinceTick.load(std::memory_order_relaxed));
+	CoreCounters::add(counters.dispatches, 1);
+	counters.busySinceTick.store(now, std::memory_order_relaxed);
+	cores[coreIndex]->busy = true;
+	process->setCoreIndex(coreIndex);
+	tracer->record(coreIndex, Tracer::DISPATCH, process->getProcessId());
+}
+
+void Scheduler::markCoreIdle(int coreIndex) {
+	CoreCounters& counters = cores[coreIndex]->counters;
+	unsigned long long now = currentTick();
+	CoreCounters::add(counters.activeTicks, now - counters.busySinceTick.load(std::memory_order_relaxed));
+	counters.idleSinceTick.store(now, std::memory_order_relaxed);
+	cores[coreIndex]->busy = false;
+}
+
+void Scheduler::dispatchToCore(int coreIndex, Process* process) {
+	// Caller holds schedulerMutex
+	CoreState& core = *cores[coreIndex];
+	markCoreBusy(coreIndex, process);
+	core.assignedProcess = process;
+	core.preemptRequested.store(false, std::memory_order_relaxed);
+	if (simulator != nullptr) {
+		simulator->beginSlice(process);
+		return;
+	}
+	core.slotCv.notify_one();
+}
+
+void Scheduler::releaseCore(int coreIndex) {
+	// Caller holds schedulerMutex
+	cores[coreIndex]->assignedProcess = nullptr;
+	markCoreIdle(coreIndex);
+	notifyDispatcher();
+}
+
+Scheduler::Residency Scheduler::ensureInMemory(Process* process, int coreIndex) {
+	// Caller holds schedulerMutex
+	if (memAllocator->isProcessInMemory(process)) {
+		return Residency::RESIDENT;
+	}
+	if (memAllocator->isProcessInBackingStore(process)) {
+		// Parked before submitting so the completion can't race the status change
+		process->setStatus(Process::WAITING);
+		if (!memAllocator->loadProcessFromBackingStore(process)) {
+			swapWaits[process->getProcessId()] = { coreIndex, currentTick() };
+			return Residency::SWAPPING_IN;
+		}
+		process->setStatus(Process::READY);
+	}
+	return memAllocator->allocateMemory(process) ? Residency::RESIDENT : Residency::NO_ROOM;
+}
+
+void Scheduler::swapInComplete(Process* process) {
+	// Runs on the swap I/O thread; the process rejoins the queue it would have been dispatched from
+	{
+		std::lock_guard<std::mutex> lock(schedulerMutex);
+		SwapWait* wait = swapWaits.find(process->getProcessId());
+		if (wait != nullptr) {
+			// Rare cross-core write, serialized with the core's own updates by schedulerMutex
+			CoreCounters::add(cores[wait->coreIndex]->counters.swapWaitTicks, currentTick() - wait->sinceTick);
+			swapWaits.erase(process->getProcessId());
+		}
+		if (schedulerType == ConfigManager::SchedulerType::MLFQ) {
+			unparkLevels();
+		}
+		else if (schedulerType == ConfigManager::SchedulerType::CFS) {
+			unparkFair();
+		}
+	}
+	process->setStatus(Process::READY);
+	addProcess(process->getHandle());
+}
+
+std::vector<ProcessHandle> Scheduler::takeFinishedProcesses() {
+	std::lock_guard<std::mutex> lock(schedulerMutex);
+	std::vector<ProcessHandle> finished;
+	finished.swap(finishedProcesses);
+	return finished;
+}
+
+void Scheduler::coreWorker(int coreIndex) {
+	CoreState& core = *cores[coreIndex];
+	Tracer::bindThreadToCore(coreIndex);
+
+	while (true) {
+		Process* process;
+		{
+			std::unique_lock<std::mutex> lock(schedulerMutex);
+			core.slotCv.wait(lock, [&] { return core.assignedProcess != nullptr || stopScheduler; });
+			if (stopScheduler) {
+				return;
+			}
+			process = core.assignedProcess;
+		}
+
+		finishSlice(process, runQuantum(process, quantumFor(process)));
+	}
+}
+
+void Scheduler::finishSlice(Process* process, bool finished) {
+	int coreIndex = process->getCoreIndex();
+	{
 		std::lock_guard<std::mutex> lock(schedulerMutex);
-		
-		for (int i = 0; i < cpuCores.size(); i++) {
-			if (!cpuCores[i] && !readyQueue.empty()) {
-				Process* process = readyQueue.front();
-				readyQueue.pop();
-				cpuCores[i] = true;
-
-				process->setCoreIndex(i);
-
-				runningProcesses[process->getProcessName()] = std::thread([process, this] {
-					process->setStatus(Process::RUNNING);
-					process->setTimestamp();
-
-					int cpuCycle = 0;
-
-					while (process->getStatus() != Process::FINISHED) {
-						if (delayPerExec == 0) {
-							process->execute();
-							process->getNextCommand();
-						}
-						else if ((cpuCycle + 1) % (delayPerExec + 1) == 0) {
-							process->execute();
-							process->getNextCommand();
-						}
-						else {
-							// Busy-waiting cycle
-						}
-						std::this_thread::sleep_for(std::chrono::milliseconds(100));
-						cpuCycle++;
-					}
-
-					std::lock_guard<std::mutex> lock(schedulerMutex);
-					cpuCores[process->getCoreIndex()] = false;
-					process->setCoreIndex(-1);
-					finishedProcesses.push_back(std::shared_ptr<Process>(process));
-					});
-
-				runningProcesses[process->getProcessName()].detach();
+		releaseCore(coreIndex);
+		tracer->record(coreIndex, finished ? Tracer::FINISH : Tracer::PREEMPT, process->getProcessId());
+		if (!finished && schedulerType == ConfigManager::SchedulerType::MLFQ) {
+			demote(process);  // Only a full quantum ends an MLFQ slice early
+			unparkLevelInto(process);
+		}
+		if (!finished && schedulerType == ConfigManager::SchedulerType::CFS) {
+			chargeVruntime(process);
+			unparkFairInto(process);
+		}
+
+		if (finished) {
+			// Process completed, remove from memory and move to finished queue
+			memAllocator->deallocateMemory(process);
+			if (schedulerType == ConfigManager::SchedulerType::MLFQ) {
+				unparkLevels();
+			}
+			else if (schedulerType == ConfigManager::SchedulerType::CFS) {
+				unparkFair();
 			}
+			process->setCoreIndex(-1);
+			finishedProcesses.push_back(process->getHandle());
+			return;
+		}
+	}
+
+	// Process quantum expired, re-queue without deallocating memory.
+	CoreCounters::add(cores[coreIndex]->counters.preemptions, 1);
+	// Pushed outside schedulerMutex so a full queue can't stall the dispatcher.
+	process->setStatus(Process::READY);
+	arrivals.push(process->getHandle());
+	wakeDispatcher();
+}
+
+bool Scheduler::runQuantum(Process* process, unsigned long long quantum) {
+	std::atomic<bool>& preemptRequested = cores[process->getCoreIndex()]->preemptRequested;
+	process->setStatus(Process::RUNNING);
+	process->setTimestamp();
+
+	int cpuCycle = 0;
+	unsigned long long executionCount = 0;
+
+	// Each cycle is one tick of the shared CPU clock; the clock waits for this core before advancing
+	unsigned long long tick = cpuClock->join();
+
+	// Execute process instructions within its quantum, or to completion when there is none
+	while ((process->getStatus() != Process::FINISHED) && (quantum == 0 || executionCount < quantum)
+		&& !preemptRequested.load(std::memory_order_relaxed)) {
+		tick = cpuClock->awaitTick(tick);
+
+		if ((cpuCycle + 1) % (delayPerExec + 1) == 0) {
+			memAllocator->accessPages(process);
+			process->execute();
+			process->getNextCommand();
+			executionCount++;
 		}
 
+		cpuCycle++;
+		cpuClock->arrive();
+	}
+
+	cpuClock->leave(tick);
+	return process->getStatus() == Process::FINISHED;
+}
+
+void Scheduler::dispatcherLoop() {
+	std::unique_lock<std::mutex> lock(schedulerMutex);
+
+	while (!stopScheduler) {
+		unsigned long long seenEvents = schedulerEvents;
+		dispatchPass();
+
+		// Sleep until a process arrives, a core is freed, or a quantum expires
+		dispatcherSleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);  // Flag store before the arrivals check
+		dispatchCv.wait(lock, [&] { return stopScheduler || schedulerEvents != seenEvents || !arrivals.empty(); });
+		dispatcherSleeping = false;
+	}
+}
+
+void Scheduler::dispatchPass() {
+	// Caller holds schedulerMutex
+	drainArrivals();
+
+	if (schedulerType == ConfigManager::SchedulerType::FCFS) {
+		fcfsLoop();
+	}
+	else if (usesShortestQueue()) {
+		shortestLoop();
+	}
+	else if (schedulerType == ConfigManager::SchedulerType::MLFQ) {
+		mlfqLoop();
+	}
+	else if (schedulerType == ConfigManager::SchedulerType::CFS) {
+		fairLoop();
+	}
+	else {
+		rrLoop();
+	}
+}
+
+void Scheduler::fcfsLoop() {
+	// Caller holds schedulerMutex
+	for (int i = 0; i < static_cast<int>(cores.size()) && !readyQueue.empty(); i++) {
+		if (!cores[i]->busy) {
+			Process* process = readyQueue.front();
+			readyQueue.pop();
+			dispatchToCore(i, process);
+		}
 	}
 }
 
 void Scheduler::rrLoop() {
-	std::chrono::time_point<std::chrono::high_resolution_clock> lastIdleTickTime = std::chrono::high_resolution_clock::now();
+	// Caller holds schedulerMutex
+	for (int i = 0; i < static_cast<int>(cores.size()) && !readyQueue.empty(); i++) {
+		if (cores[i]->busy) {
+			continue;
+		}
 
-	while (true) {
-		std::lock_guard<std::mutex> lock(schedulerMutex);
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastIdleTickTime);
-
-		for (int i = 0; i < cpuCores.size(); i++) {
-			if (!cpuCores[i] && !readyQueue.empty()) {
-				Process* process = readyQueue.front();
-				// Attempt to allocate memory if the process isn't already in memory
-				if (!memAllocator->isProcessInMemory(process)) {
-					if (memAllocator->backingStoreSet.contains(process->getProcessName())) {
-						process = memAllocator->loadProcessFromBackingStore(process->getProcessName());
-					}
-					if (!memAllocator->allocateMemory(process)) {
-						// Memory allocation failed, so re-queue to try later
-						readyQueue.push(readyQueue.front());
-						readyQueue.pop();
-						continue;
-					}
-				}
-				// Memory allocation successful or process already in memory
-				readyQueue.pop();
-				cpuCores[i] = true;
-				process->setCoreIndex(i);
-
-				// Start a thread for the process execution
-				runningProcesses[process->getProcessName()] = std::thread([process, this] {
-					process->setStatus(Process::RUNNING);
-					process->setTimestamp();
-
-					int cpuCycle = 0;
-					int executionCount = 0;
-
-					// Execute process instructions within its quantum
-					while ((process->getStatus() != Process::FINISHED) && executionCount < quantumCycles) {
-						if (delayPerExec == 0) {
-							process->execute();
-							process->getNextCommand();
-							executionCount++;
-							activeCpuTicks += 1;
-						}
-						else if ((cpuCycle + 1) % (delayPerExec + 1) == 0) {
-							process->execute();
-							process->getNextCommand();
-							activeCpuTicks += 1;
-							executionCount++;
-						}
-						
-						std::this_thread::sleep_for(std::chrono::milliseconds(20));
-						cpuCycle++;
-					}
-
-					std::lock_guard<std::mutex> lock(schedulerMutex);
-
-					cpuCores[process->getCoreIndex()] = false;
-
-					if (process->getStatus() == Process::FINISHED) {
-						// Process completed, remove from memory and move to finished queue
-						memAllocator->deallocateMemory(process);
-						finishedProcesses.push_back(std::shared_ptr<Process>(process));
-						runningProcesses.erase(process->getProcessName());
-					}
-					else {
-						// Process quantum expired, re-queue without deallocating memory
-						process->setStatus(Process::READY);
-						readyQueue.push(process);
-					}
-
-					});
-
-				// Detach the thread to allow it to run independently
-				runningProcesses[process->getProcessName()].detach();
+		// Try each queued process once; those that don't fit in memory rotate to the back
+		for (size_t attempts = readyQueue.size(); attempts > 0; attempts--) {
+			Process* process = readyQueue.front();
+			readyQueue.pop();
+
+			// Attempt to allocate memory if the process isn't already in memory
+			Residency residency = ensureInMemory(process, i);
+			if (residency == Residency::SWAPPING_IN) {
+				continue;  // Parked in WAITING until its swap-in completes
+			}
+			if (residency == Residency::NO_ROOM) {
+				// Memory allocation failed, so re-queue to try later
+				readyQueue.push(process);
+				continue;
+			}
+
+			// Memory allocation successful or process already in memory
+			dispatchToCore(i, process);
+			break;
+		}
+	}
+}
+
+void Scheduler::shortestLoop() {
+	// Caller holds schedulerMutex
+	std::vector<ShortestEntry> noRoom;  // Popped but didn't fit in memory; returned to the heap after the pass
+	for (int i = 0; i < static_cast<int>(cores.size()) && !shortestQueue.empty(); i++) {
+		if (cores[i]->busy) {
+			continue;
+		}
+
+		while (!shortestQueue.empty()) {
+			ShortestEntry entry = shortestQueue.top();
+			shortestQueue.pop();
+
+			Residency residency = ensureInMemory(entry.process, i);
+			if (residency == Residency::SWAPPING_IN) {
+				continue;  // Parked in WAITING until its swap-in completes
 			}
-			else if (!cpuCores[i]) {
-				if (duration.count() >= 20) {
-					idleCpuTicks += 1;
-					lastIdleTickTime = std::chrono::high_resolution_clock::now();
+			if (residency == Residency::NO_ROOM) {
+				entry.noRoom = true;
+				noRoom.push_back(entry);
+				continue;
+			}
+
+			dispatchToCore(i, entry.process);
+			break;
+		}
+	}
+	for (const ShortestEntry& entry : noRoom) {
+		shortestQueue.push(entry);
+	}
+
+	if (schedulerType == ConfigManager::SchedulerType::SRTF && simulator == nullptr) {
+		requestShorterPreemption();
+	}
+}
+
+void Scheduler::requestShorterPreemption() {
+	// Caller holds schedulerMutex. One preemption in flight at a time: the freed core triggers
+	// another pass, which rechecks the next shortest process against what is still running.
+	if (shortestQueue.empty()) {
+		return;
+	}
+
+	int longestCore = -1;
+	size_t longestRemaining = 0;
+	for (int i = 0; i < static_cast<int>(cores.size()); i++) {
+		Process* running = cores[i]->assignedProcess;
+		if (running == nullptr) {
+			return;  // A core is free (waiting on memory); no need to preempt
+		}
+		if (cores[i]->preemptRequested.load(std::memory_order_relaxed)) {
+			return;
+		}
+		size_t remaining = running->getRemainingCommands();
+		if (remaining > longestRemaining) {
+			longestRemaining = remaining;
+			longestCore = i;
+		}
+	}
+
+	if (longestCore != -1 && shorterProcessWaiting(cores[longestCore]->assignedProcess)) {
+		cores[longestCore]->preemptRequested.store(true, std::memory_order_relaxed);
+	}
+}
+
+bool Scheduler::shorterProcessWaiting(Process* running) const {
+	// Caller holds schedulerMutex. A head that found no memory couldn't take the core anyway.
+	if (shortestQueue.empty()) {
+		return false;
+	}
+	const ShortestEntry& shortest = shortestQueue.top();
+	return !shortest.noRoom && shortest.remaining < running->getRemainingCommands();
+}
+
+void Scheduler::mlfqLoop() {
+	// Caller holds schedulerMutex
+	if (currentTick() >= nextBoostTick) {
+		boostPriorities();
+		nextBoostTick = currentTick() + mlfqBoostTicks;
+	}
+
+	// A process that doesn't fit is parked until memory is freed, so later passes don't pay for
+	// another failed search. Within a pass, larger non-resident ones are parked without trying.
+	int smallestNoRoom = std::numeric_limits<int>::max();
+	for (int i = 0; i < static_cast<int>(cores.size()); i++) {
+		if (cores[i]->busy) {
+			continue;
+		}
+
+		// Highest non-empty level first
+		bool dispatched = false;
+		for (int level = 0; level < mlfqLevels && !dispatched; level++) {
+			std::deque<Process*>& queue = levelQueues[level];
+			while (!queue.empty()) {
+				Process* process = queue.front();
+				queue.pop_front();
+				Residency residency = process->getMemorySize() >= smallestNoRoom && !memAllocator->isProcessInMemory(process)
+					? Residency::NO_ROOM : ensureInMemory(process, i);
+				if (residency == Residency::NO_ROOM) {
+					smallestNoRoom = std::min(smallestNoRoom, process->getMemorySize());
+					levelParked.push_back(process);
+					levelParkedMinSize = std::min(levelParkedMinSize, process->getMemorySize());
+					continue;
 				}
+				if (residency == Residency::SWAPPING_IN) {
+					continue;  // Parked in WAITING until its swap-in completes
+				}
+
+				dispatchToCore(i, process);
+				dispatched = true;
+				break;
+			}
+			publishLevelDepth(level);
+		}
+		if (!dispatched) {
+			break;  // Every level is empty or parked
+		}
+	}
+	levelParkedDepth.store(levelParked.size(), std::memory_order_relaxed);
+}
+
+void Scheduler::unparkLevels() {
+	// Caller holds schedulerMutex. Parked processes rejoin the back of their level in the order they were parked.
+	for (Process* process : levelParked) {
+		levelQueues[process->getPriorityLevel()].push_back(process);
+	}
+	levelParked.clear();
+	levelParkedMinSize = std::numeric_limits<int>::max();
+	for (int level = 0; level < mlfqLevels; level++) {
+		publishLevelDepth(level);
+	}
+	levelParkedDepth.store(0, std::memory_order_relaxed);
+}
+
+void Scheduler::unparkLevelInto(Process* preempted) {
+	// Caller holds schedulerMutex. Same as unparkFairInto: the preempted process can now be swapped
+	// out, so the longest-parked process no larger than it gets one more try.
+	int size = preempted->getMemorySize();
+	if (size < levelParkedMinSize) {
+		return;
+	}
+	int smallest = std::numeric_limits<int>::max();
+	for (Process*& process : levelParked) {
+		if (process->getMemorySize() <= size) {
+			int level = process->getPriorityLevel();
+			levelQueues[level].push_back(process);
+			publishLevelDepth(level);
+			process = levelParked.back();
+			levelParked.pop_back();
+			levelParkedDepth.store(levelParked.size(), std::memory_order_relaxed);
+			return;
+		}
+		smallest = std::min(smallest, process->getMemorySize());
+	}
+	levelParkedMinSize = smallest;  // The bound was stale; nothing parked fits
+}
+
+void Scheduler::boostPriorities() {
+	// Caller holds schedulerMutex. Everything returns to the top level so long-running
+	// processes demoted to the bottom can't starve behind a stream of short ones.
+	std::deque<Process*>& top = levelQueues[0];
+	for (int level = 1; level < mlfqLevels; level++) {
+		for (Process* process : levelQueues[level]) {
+			process->setPriorityLevel(0);
+			top.push_back(process);
+		}
+		levelQueues[level].clear();
+		publishLevelDepth(level);
+	}
+	publishLevelDepth(0);
+	for (Process* process : levelParked) {
+		process->setPriorityLevel(0);  // Rejoins the top level once it is unparked
+	}
+
+	for (auto& core : cores) {
+		if (core->assignedProcess != nullptr) {
+			core->assignedProcess->setPriorityLevel(0);
+		}
+	}
+	boostCount++;
+}
+
+void Scheduler::demote(Process* process) {
+	// Caller holds schedulerMutex
+	int level = process->getPriorityLevel();
+	if (level + 1 < mlfqLevels) {
+		process->setPriorityLevel(level + 1);
+		demotionCount++;
+	}
+}
+
+void Scheduler::publishLevelDepth(int level) {
+	levelDepths[level].store(levelQueues[level].size(), std::memory_order_relaxed);
+}
+
+void Scheduler::fairLoop() {
+	// Caller holds schedulerMutex. Picking is begin() plus an erase. A process that doesn't fit
+	// is parked until memory is freed, so later passes don't rescan it.
+	int smallestNoRoom = std::numeric_limits<int>::max();
+	for (int i = 0; i < static_cast<int>(cores.size()) && !fairQueue.empty(); i++) {
+		if (cores[i]->busy) {
+			continue;
+		}
+
+		while (!fairQueue.empty()) {
+			FairEntry entry = *fairQueue.begin();
+			fairQueue.erase(fairQueue.begin());
+			if (entry.vruntime > minVruntime.load(std::memory_order_relaxed)) {
+				minVruntime.store(entry.vruntime, std::memory_order_relaxed);
+			}
+
+			// Larger than one that already failed this pass: park it without another failed search
+			Process* process = entry.process;
+			Residency residency = process->getMemorySize() >= smallestNoRoom && !memAllocator->isProcessInMemory(process)
+				? Residency::NO_ROOM : ensureInMemory(process, i);
+			if (residency == Residency::NO_ROOM) {
+				smallestNoRoom = std::min(smallestNoRoom, process->getMemorySize());
+				fairParked.push_back(entry);
+				fairParkedMinSize = std::min(fairParkedMinSize, process->getMemorySize());
+				continue;
+			}
+			if (residency == Residency::SWAPPING_IN) {
+				continue;  // Parked in WAITING until its swap-in completes
+			}
+
+			dispatchToCore(i, process);
+			break;
+		}
+	}
+	publishFairDepth();
+}
+
+void Scheduler::unparkFair() {
+	// Caller holds schedulerMutex. Like any returning process, a parked one keeps its vruntime
+	// unless the queue minimum has moved past it while it waited.
+	unsigned long long floor = minVruntime.load(std::memory_order_relaxed);
+	for (const FairEntry& entry : fairParked) {
+		unsigned long long vruntime = std::max(entry.vruntime, floor);
+		entry.process->setVruntime(vruntime);
+		fairQueue.insert({ vruntime, entry.sequence, entry.process });
+	}
+	fairParked.clear();
+	fairParkedMinSize = std::numeric_limits<int>::max();
+	publishFairDepth();
+}
+
+void Scheduler::unparkFairInto(Process* preempted) {
+	// Caller holds schedulerMutex. A preempted process can now be swapped out, which makes room for
+	// at most one parked process no larger than it; retrying more would just rescan the list.
+	int size = preempted->getMemorySize();
+	if (size < fairParkedMinSize) {
+		return;
+	}
+	int smallest = std::numeric_limits<int>::max();
+	for (FairEntry& entry : fairParked) {
+		if (entry.process->getMemorySize() <= size) {
+			// Longest parked first. Swapping in the back entry leaves the minimum size a lower bound.
+			unsigned long long vruntime = std::max(entry.vruntime, minVruntime.load(std::memory_order_relaxed));
+			entry.process->setVruntime(vruntime);
+			fairQueue.insert({ vruntime, entry.sequence, entry.process });
+			entry = fairParked.back();
+			fairParked.pop_back();
+			publishFairDepth();
+			return;
+		}
+		smallest = std::min(smallest, entry.process->getMemorySize());
+	}
+	fairParkedMinSize = smallest;  // The bound was stale; nothing parked fits
+}
+
+void Scheduler::publishFairDepth() {
+	fairDepth.store(fairQueue.size() + fairParked.size(), std::memory_order_relaxed);
+	fairParkedDepth.store(fairParked.size(), std::memory_order_relaxed);
+}
+
+void Scheduler::chargeVruntime(Process* process) {
+	// Caller holds schedulerMutex. Heavier processes accumulate vruntime more slowly, so they
+	// return to the left of the queue sooner and get a larger share of the cores.
+	int steps = process->getCommandIndex();
+	unsigned long long executed = static_cast<unsigned long long>(steps - process->getChargedSteps());
+	unsigned long long weight = niceWeights[process->getNice() + 20];
+	process->setVruntime(process->getVruntime() + executed * nice0Weight * 1024 / weight);
+	process->setChargedSteps(steps);
+}
+
+void Scheduler::wakeWorkers(bool all) {
+	// Only take the lock when a worker is actually parked on workCv; waking all also
+	// releases the workers waiting for memory, so shutdown reaches every thread
+	if (all || sleepingWorkers > 0) {
+		std::lock_guard<std::mutex> lock(workMutex);
+		if (all) {
+			workCv.notify_all();
+			memoryCv.notify_all();
+		}
+		else {
+			workCv.notify_one();
+		}
+	}
+}
+
+void Scheduler::memoryFreed() {
+	// Bumped under workMutex so a worker between its predicate check and its wait cannot miss it
+	{
+		std::lock_guard<std::mutex> lock(workMutex);
+		memoryEvents++;
+	}
+	memoryCv.notify_all();
+}
+
+void Scheduler::pushLocal(int coreIndex, Process* process) {
+	CoreState& core = *cores[coreIndex];
+	{
+		std::lock_guard<std::mutex> lock(core.queueMutex);
+		core.localQueue.push_back(process);
+	}
+	queuedWork++;
+	wakeWorkers(false);
+}
+
+Process* Scheduler::popLocal(int coreIndex) {
+	// The owner takes from the front of its own queue
+	CoreState& core = *cores[coreIndex];
+	std::lock_guard<std::mutex> lock(core.queueMutex);
+	if (core.localQueue.empty()) {
+		return nullptr;
+	}
+	Process* process = core.localQueue.front();
+	core.localQueue.pop_front();
+	queuedWork--;
+	return process;
+}
+
+Process* Scheduler::stealWork(int thiefIndex, std::mt19937& rng) {
+	// Start at a random victim and take from the back of its queue
+	int numCores = static_cast<int>(cores.size());
+	int start = std::uniform_int_distribution<int>(0, numCores - 1)(rng);
+
+	for (int offset = 0; offset < numCores; offset++) {
+		int victimIndex = (start + offset) % numCores;
+		if (victimIndex == thiefIndex) {
+			continue;
+		}
+
+		CoreState& victim = *cores[victimIndex];
+		std::lock_guard<std::mutex> lock(victim.queueMutex);
+		if (!victim.localQueue.empty()) {
+			Process* process = victim.localQueue.back();
+			victim.localQueue.pop_back();
+			queuedWork--;
+			stealCount++;
+			return process;
+		}
+	}
+	return nullptr;
+}
+
+void Scheduler::wsWorker(int coreIndex) {
+	Tracer::bindThreadToCore(coreIndex);
+	std::mt19937 rng(coreIndex + 1);
+	size_t failedAllocations = 0;  // Consecutive processes that did not fit in memory
+	unsigned long long seenMemoryEvents = memoryEvents;
+
+	while (!stopScheduler) {
+		Process* process = popLocal(coreIndex);
+		if (process == nullptr) {
+			process = stealWork(coreIndex, rng);
+		}
+
+		if (process == nullptr) {
+			// Nothing to run anywhere; sleep until work is queued
+			std::unique_lock<std::mutex> lock(workMutex);
+			sleepingWorkers++;
+			workCv.wait(lock, [&] { return stopScheduler || queuedWork > 0; });
+			sleepingWorkers--;
+			continue;
+		}
+
+		Residency residency;
+		{
+			std::lock_guard<std::mutex> lock(schedulerMutex);
+			residency = ensureInMemory(process, coreIndex);
+		}
+
+		if (residency == Residency::SWAPPING_IN) {
+			continue;  // Parked in WAITING; the swap I/O thread requeues it
+		}
+		if (residency == Residency::NO_ROOM) {
+			// Park it at the back of this core's queue and try the next one
+			pushLocal(coreIndex, process);
+			failedAllocations++;
+
+			size_t queued;
+			{
+				std::lock_guard<std::mutex> lock(cores[coreIndex]->queueMutex);
+				queued = cores[coreIndex]->localQueue.size();
 			}
+
+			if (failedAllocations > queued) {
+				// Nothing here fits; wait until a finished process frees memory
+				std::unique_lock<std::mutex> lock(workMutex);
+				memoryCv.wait(lock, [&] { return stopScheduler || memoryEvents != seenMemoryEvents; });
+				seenMemoryEvents = memoryEvents;
+				failedAllocations = 0;
+			}
+			continue;
+		}
+		failedAllocations = 0;
+
+		int lastCore = process->getCoreIndex();
+		if (lastCore != -1 && lastCore != coreIndex) {
+			migrationCount++;
+		}
+		markCoreBusy(coreIndex, process);
+
+		bool finished = runQuantum(process, quantumFor(process));
+		markCoreIdle(coreIndex);
+		tracer->record(coreIndex, finished ? Tracer::FINISH : Tracer::PREEMPT, process->getProcessId());
+
+		if (finished) {
+			{
+				std::lock_guard<std::mutex> lock(schedulerMutex);
+				memAllocator->deallocateMemory(process);
+				process->setCoreIndex(-1);
+				finishedProcesses.push_back(process->getHandle());
+			}
+			memoryFreed();
+		}
+		else {
+			// Quantum expired; requeue on the core that just ran it
+			CoreCounters::add(cores[coreIndex]->counters.preemptions, 1);
+			process->setStatus(Process::READY);
+			pushLocal(coreIndex, process);
 		}
 	}
 }
@@ -8,33 +8,175 @@
 #include <vector>
 #include <mutex>
 #include <map>
+#include <set>
+#include <memory>
 #include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <random>
+#include <limits>
 #include "ConfigManager.h"
 #include "MemoryAllocator.h"
+#include "ReadyQueue.h"
+#include "ProcessPool.h"
+#include "CpuClock.h"
+#include "CoreCounters.h"
+#include "PidMap.h"
+#include "Tracer.h"
+
+class Simulator;
 
 class Scheduler {
+    friend class Simulator;
 
 private:
   MemoryAllocator* memAllocator;
+  ProcessPool* processPool;  // Resolves the handles queued by addProcess
+  Tracer* tracer;            // Records dispatch, preempt and finish events per core
 
     ConfigManager::SchedulerType schedulerType;
     int quantumCycles;  // For Round-Robin scheduling
 	  int delayPerExec;  // Delay between each instruction execution
 	  int batchProcessFreq;  // Frequency of batch process creation
 
-    std::queue<Process*> readyQueue; // All processes ready to go once a thread yields
-	  std::map<std::string, std::thread> runningProcesses; // Processes currently running
-    std::vector<std::shared_ptr<Process>> finishedProcesses; // Add finished processes here
-    std::vector<bool> cpuCores;  // Keeps track of available CPU cores
+    // Per-core state for the long-lived worker owned by each emulated core
+    struct CoreState {
+      std::thread worker;                 // Worker thread bound to this core
+      std::condition_variable slotCv;     // Signals the worker that its slot was filled
+      Process* assignedProcess = nullptr; // Handoff slot filled by the dispatcher
+      std::atomic<bool> busy{ false };    // Readable without schedulerMutex
+      std::atomic<bool> preemptRequested{ false };  // SRTF: a shorter process is waiting; end the slice early
+      CoreCounters counters;              // Tick and slice accounting on its own cache line
+
+      // Work-stealing mode: processes owned by this core
+      std::mutex queueMutex;
+      std::deque<Process*> localQueue;
+    };
+
+    ReadyQueue<ProcessHandle> arrivals;  // Lock-free inbox for new and requeued processes
+    std::queue<Process*> readyQueue; // Dispatcher-owned queue, refilled from arrivals
+
+    // SJF/SRTF ready heap, ordered by remaining instructions, which can't change while queued
+    struct ShortestEntry {
+      size_t remaining;
+      unsigned long long sequence;  // Tie-breaker so equal lengths run in arrival order
+      Process* process;
+      bool noRoom;  // Last dispatch attempt found no memory; preempting a core won't let it run
+
+      bool operator>(const ShortestEntry& other) const {
+        return remaining != other.remaining ? remaining > other.remaining : sequence > other.sequence;
+      }
+    };
+    std::priority_queue<ShortestEntry, std::vector<ShortestEntry>, std::greater<ShortestEntry>> shortestQueue;
+    unsigned long long nextShortestSequence = 0;
+
+    // MLFQ: one FIFO per priority level, level 0 first. Depths are mirrored into atomics
+    // so screen -ls can show them without taking schedulerMutex.
+    int mlfqLevels = 1;
+    unsigned long long mlfqBoostTicks = 0;
+    unsigned long long nextBoostTick = 0;
+    std::vector<std::deque<Process*>> levelQueues;
+    std::unique_ptr<std::atomic<size_t>[]> levelDepths;
+    std::vector<Process*> levelParked;  // Didn't fit in memory; rejoin their level when memory is freed
+    int levelParkedMinSize = std::numeric_limits<int>::max();  // No larger than any parked process
+    std::atomic<size_t> levelParkedDepth{ 0 };
+    std::atomic<unsigned long long> demotionCount{ 0 };
+    std::atomic<unsigned long long> boostCount{ 0 };
+
+    // CFS: runnable processes ordered by virtual runtime, leftmost runs next
+    struct FairEntry {
+      unsigned long long vruntime;
+      unsigned long long sequence;  // Tie-breaker so equal vruntimes run in queue order
+      Process* process;
+
+      bool operator<(const FairEntry& other) const {
+        return vruntime != other.vruntime ? vruntime < other.vruntime : sequence < other.sequence;
+      }
+    };
+    std::set<FairEntry> fairQueue;
+    std::vector<FairEntry> fairParked;  // Didn't fit in memory; rejoin fairQueue when memory is freed
+    int fairParkedMinSize = std::numeric_limits<int>::max();  // No larger than any parked process
+    unsigned long long nextFairSequence = 0;
+    // Never decreases; processes are queued no earlier than this so a long wait can't bank credit.
+    // Mirrored into atomics with the queue sizes for screen -ls.
+    std::atomic<unsigned long long> minVruntime{ 0 };
+    std::atomic<size_t> fairDepth{ 0 };
+    std::atomic<size_t> fairParkedDepth{ 0 };
+    std::vector<std::unique_ptr<CoreState>> cores; // One worker per emulated core
+    std::vector<ProcessHandle> finishedProcesses; // Retired processes, not yet reaped
     std::mutex schedulerMutex;
-    bool stopScheduler = false;
+    std::condition_variable dispatchCv;  // Wakes the dispatcher when a scheduling event occurs
+    unsigned long long schedulerEvents = 0;  // Bumped on every event, guarded by schedulerMutex
+    std::thread dispatcherThread;
+    std::atomic<bool> dispatcherSleeping{ false };  // Set while the dispatcher waits on dispatchCv
+    // Processes parked in WAITING on a swap-in, guarded by schedulerMutex
+    struct SwapWait {
+      int coreIndex = 0;                // Core whose dispatch attempt parked the process
+      unsigned long long sinceTick = 0;
+    };
+    PidMap<SwapWait> swapWaits;
+    Simulator* simulator = nullptr;  // Set in simulate mode, where no threads are started
+    CpuClock* cpuClock = nullptr;    // Shared tick source for realtime mode
+    std::atomic<bool> stopScheduler{ false };
+
+    // Work-stealing mode bookkeeping
+    std::mutex workMutex;
+    std::condition_variable workCv;    // Wakes idle workers when work is queued
+    std::condition_variable memoryCv;  // Wakes workers whose queue did not fit when memory is freed
+    std::atomic<long long> queuedWork{ 0 };  // Processes sitting in local queues
+    std::atomic<int> sleepingWorkers{ 0 };
+    std::atomic<unsigned long long> memoryEvents{ 0 };  // Bumped whenever a finished process frees memory
+    std::atomic<unsigned int> nextCore{ 0 };  // Round-robin placement of new processes
+    std::atomic<unsigned long long> stealCount{ 0 };
+    std::atomic<unsigned long long> migrationCount{ 0 };
 
     void fcfsLoop();
     void rrLoop();
+    void shortestLoop();
+    void mlfqLoop();
+    void boostPriorities();
+    void demote(Process* process);
+    void publishLevelDepth(int level);
+    void unparkLevels();
+    void unparkLevelInto(Process* preempted);
+    void fairLoop();
+    void chargeVruntime(Process* process);
+    void unparkFair();
+    void unparkFairInto(Process* preempted);
+    void publishFairDepth();
+    void requestShorterPreemption();
+    bool shorterProcessWaiting(Process* running) const;  // SRTF: the queue head would preempt running
+    void enqueueReady(Process* process);
+    bool usesShortestQueue() const;
+    unsigned long long quantumFor(Process* process) const;  // Instructions per slice, 0 to run to completion
+    void dispatcherLoop();
+    void dispatchPass();
+    void finishSlice(Process* process, bool finished);
+    unsigned long long currentTick();
+    void notifyDispatcher();
+    void wakeDispatcher();
+    void drainArrivals();
+    void dispatchToCore(int coreIndex, Process* process);
+    void releaseCore(int coreIndex);
+    void markCoreBusy(int coreIndex, Process* process);
+    void markCoreIdle(int coreIndex);
+    enum Residency { RESIDENT, NO_ROOM, SWAPPING_IN };  // Outcome of ensureInMemory
+    Residency ensureInMemory(Process* process, int coreIndex);
+    void swapInComplete(Process* process);
+    void coreWorker(int coreIndex);
+    bool runQuantum(Process* process, unsigned long long quantum);
+
+    void wsWorker(int coreIndex);
+    void pushLocal(int coreIndex, Process* process);
+    Process* popLocal(int coreIndex);
+    Process* stealWork(int thiefIndex, std::mt19937& rng);
+    void wakeWorkers(bool all);
+    void memoryFreed();
 
 public:
-    Scheduler(ConfigManager* newConfig, MemoryAllocator* resManager);
+    Scheduler(ConfigManager* newConfig, MemoryAllocator* resManager, ProcessPool* pool, Tracer* eventTracer);
     ~Scheduler();
+    void stop();  // Stops the clock and joins the dispatcher and workers; counters stay readable
 
     struct CpuUtilization
     {
@@ -44,15 +186,22 @@ public:
     };
 
 
-    void addProcess(Process* newProcess);
+    void addProcess(ProcessHandle newProcess);
+    std::vector<ProcessHandle> takeFinishedProcesses();  // Processes the scheduler no longer references
     void start();
 
 
-    unsigned long long idleCpuTicks = 0;
-		int activeCpuTicks = 0;
-
+    CpuStats getCpuStats();  // Sums the per-core counters, including spans still in progress
+    unsigned long long getIdleCpuTicks();
+    unsigned long long getActiveCpuTicks();
+    bool isSimulating() const { return simulator != nullptr; }
+    unsigned long long getSimulatedTick();
+    CpuClock* getCpuClock() const { return cpuClock; }
+    void advanceTo(unsigned long long tick);
     CpuUtilization getCpuUtilization();
-    std::vector<bool> getCpuCores() { return cpuCores; };
+    std::vector<bool> getCpuCores();
+    unsigned long long getStealCount() const { return stealCount; }
+    unsigned long long getMigrationCount() const { return migrationCount; }
 
     void displayCpuUtilization();
 };
@@ -0,0 +1,77 @@
+#include "Simulator.h"
+#include "Scheduler.h"
+#include <mutex>
+#include <algorithm>
+
+Simulator::Simulator(Scheduler* scheduler) : scheduler(scheduler) {
+}
+
+void Simulator::beginSlice(Process* process) {
+	process->setStatus(Process::RUNNING);
+	process->setTimestamp();
+	runSegment(process);
+}
+
+void Simulator::runSegment(Process* process) {
+	// FCFS and SJF run to completion; RR stops after quantumCycles instructions
+	unsigned long long quantum = scheduler->quantumFor(process);
+	bool srtf = scheduler->schedulerType == ConfigManager::SchedulerType::SRTF;
+	if (srtf) {
+		// Processes only arrive between runUntil calls, so stopping at the horizon lets
+		// the next runUntil weigh every newcomer against this process
+		unsigned long long ticksLeft = horizonTick > currentTick ? horizonTick - currentTick : 0;
+		quantum = std::max<unsigned long long>(ticksLeft / (scheduler->delayPerExec + 1), 1);
+	}
+	unsigned long long executed = 0;
+	while (process->getStatus() != Process::FINISHED && (quantum == 0 || executed < quantum)) {
+		scheduler->memAllocator->accessPages(process);
+		process->execute();
+		process->getNextCommand();
+		executed++;
+	}
+
+	// Each instruction occupies the core for delay-per-exec + 1 ticks
+	unsigned long long sliceTicks = executed * (scheduler->delayPerExec + 1);
+	if (sliceTicks == 0) {
+		sliceTicks = 1;  // Never release a core at the tick it was dispatched
+	}
+
+	bool finished = process->getStatus() == Process::FINISHED;
+	events.push({ currentTick + sliceTicks, nextSequence++, process, finished, srtf && !finished });
+}
+
+void Simulator::runUntil(unsigned long long targetTick) {
+	horizonTick = targetTick;
+	dispatch();
+
+	// Horizon checkpoints at targetTick wait for the next call, after that tick's arrivals are queued
+	while (!events.empty() && (events.top().tick < targetTick
+		|| (events.top().tick == targetTick && !events.top().atHorizon))) {
+		SliceEnd slice = events.top();
+		events.pop();
+
+		currentTick = slice.tick;
+		if (slice.atHorizon) {
+			bool preempt;
+			{
+				std::lock_guard<std::mutex> lock(scheduler->schedulerMutex);
+				preempt = scheduler->shorterProcessWaiting(slice.process);
+			}
+			if (!preempt) {
+				runSegment(slice.process);  // Same slice continues; no dispatch or preemption is counted
+				continue;
+			}
+		}
+		scheduler->finishSlice(slice.process, slice.finished);
+		dispatch();
+	}
+
+	if (targetTick > currentTick) {
+		currentTick = targetTick;
+	}
+}
+
+void Simulator::dispatch() {
+	std::lock_guard<std::mutex> lock(scheduler->schedulerMutex);
+	scheduler->dispatchPass();
+}
@@ -0,0 +1,47 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "Process.h"
+#include <queue>
+#include <vector>
+
+class Scheduler;
+
+// Discrete-event driver for simulate mode.
+// Instead of worker threads sleeping through wall-clock cycles, each dispatch
+// executes its slice immediately and schedules a slice-end event at the virtual
+// tick the core would have released it. Time jumps straight from one event to
+// the next, reusing the Scheduler's dispatch and completion paths.
+class Simulator {
+public:
+	Simulator(Scheduler* scheduler);
+
+	void beginSlice(Process* process);  // Called when the dispatcher fills a core
+	void runUntil(unsigned long long targetTick);      // Processes every event up to targetTick
+
+	unsigned long long getCurrentTick() const { return currentTick; }
+
+private:
+	struct SliceEnd {
+		unsigned long long tick;      // Virtual tick when the core is released
+		unsigned long long sequence;  // Tie-breaker so equal ticks complete in dispatch order
+		Process* process;
+		bool finished;
+		bool atHorizon;  // SRTF segment cut at the horizon; the process keeps its core unless a shorter one waits
+
+		bool operator>(const SliceEnd& other) const {
+			return tick != other.tick ? tick > other.tick : sequence > other.sequence;
+		}
+	};
+
+	Scheduler* scheduler;
+	std::priority_queue<SliceEnd, std::vector<SliceEnd>, std::greater<SliceEnd>> events;
+	unsigned long long currentTick = 0;
+	unsigned long long horizonTick = 0;  // Target of the current runUntil; nothing arrives before it
+	unsigned long long nextSequence = 0;
+
+	void dispatch();
+	void runSegment(Process* process);  // Executes the next stretch of the slice and schedules its end
+};
+
+#endif // SIMULATOR_H
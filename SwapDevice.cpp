@@ -0,0 +1,112 @@
+#include "SwapDevice.h"
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+SwapDevice::SwapDevice(const std::string& directory, bool asynchronous)
+	: asynchronous(asynchronous), backingStore(directory) {
+	if (asynchronous) {
+		ioThread = std::thread(&SwapDevice::ioLoop, this);
+	}
+}
+
+SwapDevice::~SwapDevice() {
+	stop();
+}
+
+void SwapDevice::stop() {
+	{
+		std::lock_guard<std::mutex> lock(deviceMutex);
+		stopping = true;
+	}
+	submitCv.notify_one();
+	if (ioThread.joinable()) {
+		ioThread.join();
+	}
+}
+
+void SwapDevice::pageOut(const SwapRecord& record) {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+	if (!asynchronous) {
+		backingStore.store(record);
+		return;
+	}
+
+	// Buffered until the I/O thread writes the next batch
+	pendingWrites[static_cast<int>(record.processId)] = record;
+	submitCv.notify_one();
+}
+
+SwapDevice::PageInResult SwapDevice::pageIn(uint32_t processId, SwapRecord& record, Completion done) {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+
+	// A page-out that hasn't been written yet is served straight from the buffer
+	SwapRecord* pending = pendingWrites.find(static_cast<int>(processId));
+	if (pending != nullptr) {
+		record = *pending;
+		pendingWrites.erase(static_cast<int>(processId));
+		return PageInResult::COMPLETED;
+	}
+
+	if (!backingStore.contains(processId)) {
+		return PageInResult::NOT_SWAPPED;
+	}
+
+	if (!asynchronous) {
+		backingStore.take(processId, record);
+		return PageInResult::COMPLETED;
+	}
+
+	pageIns.push_back({ processId, std::move(done) });
+	submitCv.notify_one();
+	return PageInResult::PENDING;
+}
+
+void SwapDevice::discard(uint32_t processId) {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+	pendingWrites.erase(static_cast<int>(processId));
+	backingStore.discard(processId);
+}
+
+bool SwapDevice::contains(uint32_t processId) const {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+	return pendingWrites.contains(static_cast<int>(processId)) || backingStore.contains(processId);
+}
+
+void SwapDevice::ioLoop() {
+	std::unique_lock<std::mutex> lock(deviceMutex);
+
+	while (true) {
+		submitCv.wait(lock, [&] { return stopping || !pendingWrites.empty() || !pageIns.empty(); });
+		if (stopping) {
+			return;
+		}
+
+		// Everything buffered since the last pass goes out as one write
+		if (!pendingWrites.empty()) {
+			pendingWrites.forEach([this](int, const SwapRecord& record) {
+				backingStore.store(record);
+			});
+			pendingWrites.clear();
+			backingStore.flush();
+			batchCount++;
+		}
+
+		std::vector<std::pair<SwapRecord, Completion>> completed;
+		for (PageInRequest& request : pageIns) {
+			SwapRecord record = {};
+			record.processId = request.processId;
+			backingStore.take(request.processId, record);
+			completed.push_back({ record, std::move(request.done) });
+		}
+		pageIns.clear();
+
+		// Completions may requeue processes, so they run without the device lock
+		lock.unlock();
+		for (auto& completion : completed) {
+			completion.second(completion.first);
+		}
+		lock.lock();
+	}
+}
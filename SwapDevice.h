@@ -0,0 +1,59 @@
+#ifndef SWAPDEVICE_H
+#define SWAPDEVICE_H
+
+#include "BackingStore.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Swap I/O front end for the backing store.
+// In asynchronous mode a dedicated I/O thread serves a submission queue: page-outs
+// are buffered write-behind and written as one batch with a single flush, and
+// page-ins complete through a callback, so callers never wait on the swap file.
+// Synchronous mode (used by the simulator) performs every request inline.
+class SwapDevice {
+public:
+	using SwapRecord = BackingStore::SwapRecord;
+	using Completion = std::function<void(const SwapRecord&)>;
+
+	SwapDevice(const std::string& directory, bool asynchronous);
+	~SwapDevice();
+
+	SwapDevice(const SwapDevice&) = delete;
+	SwapDevice& operator=(const SwapDevice&) = delete;
+
+	enum PageInResult { NOT_SWAPPED, COMPLETED, PENDING };
+
+	void pageOut(const SwapRecord& record);
+	// COMPLETED fills record immediately; PENDING runs done on the I/O thread once the slot is read
+	PageInResult pageIn(uint32_t processId, SwapRecord& record, Completion done);
+	void discard(uint32_t processId);
+	void stop();  // Joins the I/O thread; page-ins still queued never complete
+	bool contains(uint32_t processId) const;
+
+	unsigned long long getBatchCount() const { return batchCount; }
+
+private:
+	struct PageInRequest {
+		uint32_t processId;
+		Completion done;
+	};
+
+	bool asynchronous;
+	BackingStore backingStore;
+
+	mutable std::mutex deviceMutex;  // Guards everything below and the backing store
+	std::condition_variable submitCv;
+	PidMap<SwapRecord> pendingWrites;  // Write-behind buffer, not yet in the swap file
+	std::deque<PageInRequest> pageIns;
+	std::atomic<unsigned long long> batchCount{ 0 };  // Batched writes issued by the I/O thread
+	bool stopping = false;
+	std::thread ioThread;
+
+	void ioLoop();
+};
+
+#endif // SWAPDEVICE_H
@@ -0,0 +1,28 @@
+#include "Timestamp.h"
+#include <ctime>
+
+using namespace std;
+
+// Wall-clock time corresponding to a steady_clock reading, taken once at startup
+static const auto wallAtStart = std::chrono::system_clock::now();
+static const long long steadyAtStart = Timestamp::now();
+
+std::string Timestamp::format(long long steadyNanoseconds) {
+	if (steadyNanoseconds == 0) {
+		return "";
+	}
+
+	auto wallTime = wallAtStart + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+		std::chrono::nanoseconds(steadyNanoseconds - steadyAtStart));
+	time_t seconds = std::chrono::system_clock::to_time_t(wallTime);
+
+	tm localtm;
+#ifdef _WIN32
+	localtime_s(&localtm, &seconds);
+#else
+	localtime_r(&seconds, &localtm);
+#endif
+	char timestamp[32];
+	strftime(timestamp, sizeof(timestamp), "(%m/%d/%Y %I:%M:%S%p)", &localtm);
+	return string(timestamp);
+}
@@ -0,0 +1,21 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <chrono>
+#include <string>
+
+// Monotonic timestamps that are cheap to take and formatted only when displayed.
+// now() reads steady_clock as nanoseconds; format() maps that back to local wall
+// time through a steady/system clock pair captured once at startup.
+class Timestamp {
+public:
+	static long long now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// "(MM/DD/YYYY HH:MM:SSAM)"; empty for a timestamp of 0 (never taken)
+	static std::string format(long long steadyNanoseconds);
+};
+
+#endif // TIMESTAMP_H
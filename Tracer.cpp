@@ -0,0 +1,115 @@
+#include "Tracer.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+thread_local int Tracer::threadCore = -1;
+
+Tracer::Tracer(int numCores) : numCores(numCores), rings(numCores + 1) {
+	clock = [] { return Timestamp::now(); };
+}
+
+void Tracer::enable() {
+	std::lock_guard<std::mutex> lock(enableMutex);
+	for (Ring& ring : rings) {
+		if (!ring.slots) {
+			ring.slots = std::make_unique<Slot[]>(ringCapacity);
+		}
+	}
+	// Release pairs with the acquire in record(), so writers see the allocated rings
+	enabled.store(true, std::memory_order_release);
+}
+
+void Tracer::disable() {
+	enabled.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::append(int core, EventType type, int pid, uint32_t arg) {
+	Ring& ring = rings[(core >= 0 && core < numCores) ? core : numCores];
+	uint64_t index = ring.head.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = ring.slots[index & (ringCapacity - 1)];
+
+	// Invalidate the slot before overwriting so a concurrent dump skips it
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.timestamp.store(clock(), std::memory_order_relaxed);
+	slot.pidAndType.store((static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 8) | type, std::memory_order_relaxed);
+	slot.arg.store(arg, std::memory_order_relaxed);
+	slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+size_t Tracer::dump(const std::string& path) const {
+	struct Event {
+		long long timestamp;
+		int track;
+		EventType type;
+		int pid;
+		uint32_t arg;
+	};
+
+	std::vector<Event> events;
+	for (int track = 0; track <= numCores; track++) {
+		const Ring& ring = rings[track];
+		if (!ring.slots) {
+			continue;
+		}
+		uint64_t head = ring.head.load(std::memory_order_acquire);
+		uint64_t first = head > ringCapacity ? head - ringCapacity : 0;
+		for (uint64_t index = first; index < head; index++) {
+			const Slot& slot = ring.slots[index & (ringCapacity - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+				continue;  // Still being written, or already overwritten
+			}
+			long long timestamp = slot.timestamp.load(std::memory_order_relaxed);
+			uint64_t pidAndType = slot.pidAndType.load(std::memory_order_relaxed);
+			uint32_t arg = slot.arg.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+				continue;
+			}
+			events.push_back({ timestamp, track, static_cast<EventType>(pidAndType & 0xFF), static_cast<int>(pidAndType >> 8), arg });
+		}
+	}
+
+	// Stable so same-timestamp events on a track keep their recorded order
+	std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.timestamp < b.timestamp; });
+
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		return 0;
+	}
+
+	long long origin = events.empty() ? 0 : events.front().timestamp;
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+	for (int track = 0; track <= numCores; track++) {
+		std::string name = track < numCores ? "Core " + std::to_string(track) : "System";
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track
+			<< ",\"args\":{\"name\":\"" << name << "\"}}," << std::endl;
+	}
+
+	static const char* const eventNames[] = { "dispatch", "preempt", "finish", "allocate", "evict", "swap-in" };
+	for (size_t i = 0; i < events.size(); i++) {
+		const Event& event = events[i];
+		double micros = (event.timestamp - origin) / 1000.0;
+		out << "{\"ts\":" << micros << ",\"pid\":0,\"tid\":" << event.track << ",";
+		switch (event.type) {
+			case DISPATCH:
+				// Dispatch opens a slice on the core's track; preempt or finish closes it
+				out << "\"ph\":\"B\",\"name\":\"pid " << event.pid << "\",\"args\":{\"pid\":" << event.pid << "}}";
+				break;
+			case PREEMPT:
+			case FINISH:
+				out << "\"ph\":\"E\",\"args\":{\"reason\":\"" << eventNames[event.type] << "\"}}";
+				break;
+			default:
+				out << "\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << eventNames[event.type]
+					<< "\",\"args\":{\"pid\":" << event.pid << ",\"pages\":" << event.arg << "}}";
+				break;
+		}
+		out << (i + 1 < events.size() ? "," : "") << std::endl;
+	}
+	out << "]}" << std::endl;
+	return events.size();
+}
@@ -0,0 +1,77 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "CoreCounters.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scheduling event recorder that can be switched on at runtime.
+// Each core has its own ring buffer, plus one system ring for the dispatcher,
+// console and swap I/O threads. While tracing is off, record() is a single
+// relaxed load. Slots carry a sequence number so dump() can read the rings while
+// they are being written and skip any slot that was overwritten mid-read.
+// dump() writes Chrome trace-event JSON that chrome://tracing and Perfetto load.
+class Tracer {
+public:
+	enum EventType : uint8_t { DISPATCH, PREEMPT, FINISH, ALLOCATE, EVICT, SWAP_IN };
+
+	Tracer(int numCores);
+
+	Tracer(const Tracer&) = delete;
+	Tracer& operator=(const Tracer&) = delete;
+
+	void enable();   // Allocates the rings on first use
+	void disable();
+	bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+	// Timestamps come from Timestamp::now() unless replaced, e.g. with virtual ticks in simulate mode.
+	// Must be set before tracing is first enabled.
+	void setClock(std::function<long long()> nanosecondClock) { clock = std::move(nanosecondClock); }
+
+	// Records on the given core's track; core -1 is the system track
+	void record(int core, EventType type, int pid, uint32_t arg = 0) {
+		if (enabled.load(std::memory_order_acquire)) {
+			append(core, type, pid, arg);
+		}
+	}
+
+	// Records on the track of the core the calling thread runs, if any
+	void recordHere(EventType type, int pid, uint32_t arg = 0) { record(threadCore, type, pid, arg); }
+
+	// Worker threads call this once so recordHere lands on their core's track
+	static void bindThreadToCore(int core) { threadCore = core; }
+
+	size_t dump(const std::string& path) const;  // Returns the number of events written, or 0 if the file can't be opened
+
+private:
+	static constexpr size_t ringCapacity = 1 << 15;  // Events kept per track; older ones are overwritten
+
+	struct Slot {
+		std::atomic<uint64_t> sequence{ 0 };   // Ring index + 1 once written, 0 while being written
+		std::atomic<int64_t> timestamp{ 0 };
+		std::atomic<uint64_t> pidAndType{ 0 }; // pid << 8 | type
+		std::atomic<uint32_t> arg{ 0 };
+	};
+
+	struct alignas(cacheLineSize) Ring {
+		std::atomic<uint64_t> head{ 0 };  // Next ring index to write
+		std::unique_ptr<Slot[]> slots;
+	};
+
+	int numCores;
+	std::vector<Ring> rings;  // One per core, then the system track
+	std::atomic<bool> enabled{ false };
+	std::mutex enableMutex;
+	std::function<long long()> clock;
+
+	static thread_local int threadCore;
+
+	void append(int core, EventType type, int pid, uint32_t arg);
+};
+
+#endif // TRACER_H
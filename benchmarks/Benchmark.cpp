@@ -0,0 +1,450 @@
+#include "ConfigManager.h"
+#include "MemoryAllocator.h"
+#include "Scheduler.h"
+#include "ProcessPool.h"
+#include "ReadyQueue.h"
+#include "BackingStore.h"
+#include "SwapDevice.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Microbenchmarks for the emulator's hot paths.
+// Each benchmark body performs a batch of operations and returns how many it did;
+// batches repeat until the time budget is spent, and the totals are reported as
+// ns/op and ops/sec. Everything runs in a scratch directory so swap files and
+// generated configs never touch the working tree.
+//
+//   emulator_bench [--quick] [filter]
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// Lets a benchmark exclude setup work from its measured time
+class Stopwatch {
+public:
+	void pause() { elapsed += Clock::now() - started; }
+	void resume() { started = Clock::now(); }
+	Clock::duration total() const { return elapsed; }
+
+private:
+	Clock::time_point started = Clock::now();
+	Clock::duration elapsed{ 0 };
+};
+
+chrono::milliseconds timeBudget(300);
+string nameFilter;
+
+void runBenchmark(const string& name, const function<size_t(Stopwatch&)>& batch) {
+	if (!nameFilter.empty() && name.find(nameFilter) == string::npos) {
+		return;
+	}
+
+	Stopwatch stopwatch;
+	size_t operations = 0;
+	while (stopwatch.total() < timeBudget) {
+		stopwatch.resume();
+		operations += batch(stopwatch);
+		stopwatch.pause();
+	}
+
+	double nanoseconds = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(stopwatch.total()).count());
+	double nsPerOp = operations > 0 ? nanoseconds / operations : 0.0;
+	cout << left << setw(36) << name << right
+		<< setw(14) << operations
+		<< setw(14) << fixed << setprecision(1) << nsPerOp
+		<< setw(16) << setprecision(0) << (nsPerOp > 0 ? 1e9 / nsPerOp : 0.0) << endl;
+}
+
+// Writes a config file from the emulator's defaults plus overrides and returns its path
+string writeConfig(const string& name, const map<string, string>& overrides) {
+	map<string, string> settings = {
+		{ "num-cpu", "4" },
+		{ "scheduler", "\"rr\"" },
+		{ "quantum-cycles", "5" },
+		{ "batch-process-freq", "1" },
+		{ "min-ins", "100" },
+		{ "max-ins", "100" },
+		{ "delay-per-exec", "0" },
+		{ "max-overall-mem", "16384" },
+		{ "mem-per-frame", "64" },
+		{ "min-mem-per-proc", "64" },
+		{ "max-mem-per-proc", "256" },
+		{ "mem-allocator", "\"flat\"" },
+		{ "mem-fit", "\"first-fit\"" },
+		{ "page-replacement", "\"fifo\"" },
+		{ "mode", "\"simulate\"" },
+	};
+	for (const auto& [key, value] : overrides) {
+		settings[key] = value;
+	}
+
+	string path = name + ".txt";
+	ofstream file(path);
+	for (const auto& [key, value] : settings) {
+		file << key << " " << value << endl;
+	}
+	return path;
+}
+
+// Creates processes sized by the config, for benchmarks that exercise one component directly
+vector<ProcessHandle> createProcesses(ProcessPool& pool, ConfigManager& config, size_t count) {
+	vector<ProcessHandle> handles;
+	for (size_t i = 0; i < count; i++) {
+		handles.push_back(pool.create("bench" + to_string(i), config.getMinIns(), config.getMaxIns(),
+			config.getMinMemPerProcess(), config.getMaxMemPerProcess(), config.getMemPerFrame()));
+	}
+	return handles;
+}
+
+void releaseProcesses(ProcessPool& pool, vector<ProcessHandle>& handles) {
+	for (ProcessHandle handle : handles) {
+		pool.release(handle);
+	}
+	handles.clear();
+}
+
+void benchReadyQueue() {
+	ReadyQueue<ProcessHandle> queue(1 << 16);
+	ProcessHandle items[64] = {};
+
+	runBenchmark("ready-queue push+pop", [&](Stopwatch&) {
+		for (uint32_t i = 0; i < 4096; i++) {
+			queue.tryPush({ i, 1 });
+		}
+		ProcessHandle handle;
+		for (int i = 0; i < 4096; i++) {
+			queue.tryPop(handle);
+		}
+		return size_t(8192);
+	});
+
+	runBenchmark("ready-queue batch push+pop (64)", [&](Stopwatch&) {
+		for (int round = 0; round < 64; round++) {
+			queue.tryPushBatch(items, 64);
+		}
+		for (int round = 0; round < 64; round++) {
+			queue.tryPopBatch(items, 64);
+		}
+		return size_t(64 * 64 * 2);
+	});
+}
+
+void benchProcessConstruction() {
+	ConfigManager config(writeConfig("process", {}));
+	ProcessPool pool;
+
+	runBenchmark("process create+release (100 ins)", [&](Stopwatch&) {
+		vector<ProcessHandle> handles = createProcesses(pool, config, 1024);
+		releaseProcesses(pool, handles);
+		return size_t(1024);
+	});
+}
+
+void benchInterpreter() {
+	ConfigManager config(writeConfig("interpreter", { { "min-ins", "100000" }, { "max-ins", "100000" } }));
+	ProcessPool pool;
+
+	runBenchmark("interpreter (instructions)", [&](Stopwatch& stopwatch) {
+		stopwatch.pause();
+		vector<ProcessHandle> handles = createProcesses(pool, config, 1);
+		Process* process = pool.get(handles[0]);
+		stopwatch.resume();
+
+		size_t executed = 0;
+		while (process->getStatus() != Process::FINISHED) {
+			process->execute();
+			process->getNextCommand();
+			executed++;
+		}
+
+		stopwatch.pause();
+		releaseProcesses(pool, handles);
+		stopwatch.resume();
+		return executed;
+	});
+}
+
+// Allocates every process then frees them in random order; sizes are mixed so the allocator fragments
+void benchAllocator(const string& name, const map<string, string>& overrides) {
+	ConfigManager config(writeConfig(name, overrides));
+	Tracer tracer(config.getNumCpu());
+	MemoryAllocator allocator(&config, &tracer);
+	ProcessPool pool;
+	vector<ProcessHandle> handles = createProcesses(pool, config, 64);
+	vector<Process*> processes;
+	for (ProcessHandle handle : handles) {
+		processes.push_back(pool.get(handle));
+	}
+	mt19937 rng(42);
+
+	runBenchmark("alloc+free " + name, [&](Stopwatch&) {
+		for (Process* process : processes) {
+			allocator.allocateMemory(process);
+		}
+		shuffle(processes.begin(), processes.end(), rng);
+		for (Process* process : processes) {
+			allocator.deallocateMemory(process);
+		}
+		return processes.size() * 2;
+	});
+	releaseProcesses(pool, handles);
+}
+
+// The flat allocator before the bitmap, kept as a baseline: allocated addresses live in a vector,
+// and every candidate address is checked with std::find, so one allocation is O(memory * allocated)
+class LinearScanFlatAllocator {
+public:
+	explicit LinearScanFlatAllocator(int maxOverallMem) : maxOverallMem(maxOverallMem) {
+		for (int i = 0; i < maxOverallMem; ++i) {
+			memoryAddresses.push_back(i);
+		}
+	}
+
+	bool allocate(Process* process) {
+		int memRequired = process->getMemorySize();
+		if (maxOverallMem - static_cast<int>(allocatedAddresses.size()) < memRequired) {
+			return false;  // The original evicted the oldest process here; the benchmark never fills memory
+		}
+
+		int consecutiveFreeAddresses = 0;
+		int startIndex = -1;
+		for (int i = 0; i < maxOverallMem; ++i) {
+			if (find(allocatedAddresses.begin(), allocatedAddresses.end(), memoryAddresses[i]) == allocatedAddresses.end()) {
+				++consecutiveFreeAddresses;
+				if (startIndex == -1) {
+					startIndex = i;
+				}
+			}
+			else {
+				consecutiveFreeAddresses = 0;
+				startIndex = -1;
+			}
+
+			if (consecutiveFreeAddresses >= memRequired) {
+				for (int j = startIndex; j < startIndex + memRequired; ++j) {
+					allocatedAddresses.push_back(memoryAddresses[j]);
+				}
+				ranges[process->getProcessId()] = { startIndex, startIndex + memRequired - 1 };
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void deallocate(Process* process) {
+		auto it = ranges.find(process->getProcessId());
+		if (it != ranges.end()) {
+			for (int i = it->second.first; i <= it->second.second; ++i) {
+				allocatedAddresses.erase(remove(allocatedAddresses.begin(), allocatedAddresses.end(), memoryAddresses[i]), allocatedAddresses.end());
+			}
+			ranges.erase(it);
+		}
+	}
+
+private:
+	int maxOverallMem;
+	vector<int> memoryAddresses;
+	vector<int> allocatedAddresses;
+	map<int, pair<int, int>> ranges;  // Process id to first and last address
+};
+
+// Same workload as benchAllocator, run against the pre-bitmap linear scan for comparison
+void benchLinearScanBaseline(const string& name, const map<string, string>& overrides) {
+	ConfigManager config(writeConfig(name, overrides));
+	LinearScanFlatAllocator allocator(config.getMaxOverallMem());
+	ProcessPool pool;
+	vector<ProcessHandle> handles = createProcesses(pool, config, 64);
+	vector<Process*> processes;
+	for (ProcessHandle handle : handles) {
+		processes.push_back(pool.get(handle));
+	}
+	mt19937 rng(42);
+
+	runBenchmark("alloc+free " + name, [&](Stopwatch&) {
+		for (Process* process : processes) {
+			allocator.allocate(process);
+		}
+		shuffle(processes.begin(), processes.end(), rng);
+		for (Process* process : processes) {
+			allocator.deallocate(process);
+		}
+		return processes.size() * 2;
+	});
+	releaseProcesses(pool, handles);
+}
+
+// Runs more processes than there are frames so every access may fault and evict
+void benchDemandPaging(const string& policy) {
+	ConfigManager config(writeConfig("paging-" + policy, {
+		{ "mem-allocator", "\"paging\"" }, { "page-replacement", "\"" + policy + "\"" },
+		{ "max-overall-mem", "2048" }, { "min-mem-per-proc", "512" }, { "max-mem-per-proc", "512" },
+		{ "min-ins", "5000" }, { "max-ins", "5000" } }));
+	Tracer tracer(config.getNumCpu());
+	MemoryAllocator allocator(&config, &tracer);
+	ProcessPool pool;
+	vector<ProcessHandle> handles;
+	vector<Process*> processes;
+
+	auto refill = [&] {
+		releaseProcesses(pool, handles);
+		handles = createProcesses(pool, config, 16);
+		processes.clear();
+		for (ProcessHandle handle : handles) {
+			processes.push_back(pool.get(handle));
+			allocator.allocateMemory(processes.back());
+		}
+	};
+	refill();
+
+	runBenchmark("demand paging access (" + policy + ")", [&](Stopwatch& stopwatch) {
+		size_t accesses = 0;
+		for (Process* process : processes) {
+			// One instruction per process per round, the way round-robin interleaves them
+			allocator.accessPages(process);
+			process->execute();
+			process->getNextCommand();
+			accesses++;
+		}
+		if (processes[0]->getStatus() == Process::FINISHED) {
+			stopwatch.pause();
+			for (Process* process : processes) {
+				allocator.deallocateMemory(process);
+			}
+			refill();
+			stopwatch.resume();
+		}
+		return accesses;
+	});
+
+	for (Process* process : processes) {
+		allocator.deallocateMemory(process);
+	}
+	releaseProcesses(pool, handles);
+}
+
+void benchSwap() {
+	BackingStore store("swap-bench");
+	runBenchmark("backing-store store+take", [&](Stopwatch&) {
+		BackingStore::SwapRecord record = {};
+		for (uint32_t pid = 1; pid <= 1024; pid++) {
+			record.processId = pid;
+			record.numPages = 4;
+			record.inUse = 1;
+			store.store(record);
+		}
+		for (uint32_t pid = 1; pid <= 1024; pid++) {
+			store.take(pid, record);
+		}
+		return size_t(1024);
+	});
+
+	SwapDevice device("swap-device-bench", false);
+	runBenchmark("swap device page-out+page-in", [&](Stopwatch&) {
+		SwapDevice::SwapRecord record = {};
+		for (uint32_t pid = 1; pid <= 1024; pid++) {
+			record.processId = pid;
+			record.numPages = 4;
+			record.inUse = 1;
+			device.pageOut(record);
+		}
+		for (uint32_t pid = 1; pid <= 1024; pid++) {
+			device.pageIn(pid, record, nullptr);
+		}
+		return size_t(1024);
+	});
+}
+
+// Whole-scheduler throughput in simulate mode: dispatch, slice, requeue and retire
+void benchScheduler(const string& name, const map<string, string>& overrides) {
+	ConfigManager config(writeConfig("scheduler-" + name, overrides));
+	Tracer tracer(config.getNumCpu());
+	MemoryAllocator allocator(&config, &tracer);
+	ProcessPool pool;
+	Scheduler scheduler(&config, &allocator, &pool, &tracer);
+
+	runBenchmark("scheduler dispatch " + name, [&](Stopwatch& stopwatch) {
+		stopwatch.pause();
+		vector<ProcessHandle> handles = createProcesses(pool, config, 256);
+		unsigned long long dispatchesBefore = scheduler.getCpuStats().dispatches;
+		stopwatch.resume();
+
+		for (ProcessHandle handle : handles) {
+			scheduler.addProcess(handle);
+		}
+		size_t finished = 0;
+		while (finished < handles.size()) {
+			scheduler.advanceTo(scheduler.getSimulatedTick() + 1000);
+			finished += scheduler.takeFinishedProcesses().size();
+		}
+
+		stopwatch.pause();
+		size_t dispatches = scheduler.getCpuStats().dispatches - dispatchesBefore;
+		releaseProcesses(pool, handles);
+		stopwatch.resume();
+		return dispatches;
+	});
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--quick") {
+			timeBudget = chrono::milliseconds(30);
+		}
+		else {
+			nameFilter = arg;
+		}
+	}
+
+	filesystem::path workDirectory = filesystem::temp_directory_path() / "csopesy_bench";
+	filesystem::remove_all(workDirectory);
+	filesystem::create_directories(workDirectory);
+	filesystem::path originalDirectory = filesystem::current_path();
+	filesystem::current_path(workDirectory);
+
+	cout << left << setw(36) << "benchmark" << right << setw(14) << "ops" << setw(14) << "ns/op" << setw(16) << "ops/sec" << endl;
+	cout << string(80, '-') << endl;
+
+	benchReadyQueue();
+	benchProcessConstruction();
+	benchInterpreter();
+	benchAllocator("flat first-fit", { { "mem-fit", "\"first-fit\"" } });
+	benchAllocator("flat best-fit", { { "mem-fit", "\"best-fit\"" } });
+	benchAllocator("flat next-fit", { { "mem-fit", "\"next-fit\"" } });
+	// Bitmap against the old linear scan on the same 4096 KB workload
+	const map<string, string> smallFlat = { { "max-overall-mem", "4096" }, { "mem-per-frame", "16" },
+		{ "min-mem-per-proc", "16" }, { "max-mem-per-proc", "64" } };
+	benchAllocator("flat 4096 bitmap", smallFlat);
+	benchLinearScanBaseline("flat 4096 linear scan", smallFlat);
+	benchAllocator("paging", { { "mem-allocator", "\"paging\"" } });
+	benchAllocator("buddy", { { "mem-allocator", "\"buddy\"" } });
+	benchDemandPaging("fifo");
+	benchDemandPaging("lru");
+	benchDemandPaging("clock");
+	benchSwap();
+	benchScheduler("fcfs", { { "scheduler", "\"fcfs\"" } });
+	benchScheduler("rr", { { "scheduler", "\"rr\"" } });
+	benchScheduler("sjf", { { "scheduler", "\"sjf\"" }, { "min-ins", "10" }, { "max-ins", "1000" } });
+	benchScheduler("srtf", { { "scheduler", "\"srtf\"" }, { "min-ins", "10" }, { "max-ins", "1000" } });
+	benchScheduler("mlfq", { { "scheduler", "\"mlfq\"" }, { "min-ins", "10" }, { "max-ins", "1000" } });
+	benchScheduler("cfs", { { "scheduler", "\"cfs\"" }, { "min-ins", "10" }, { "max-ins", "1000" } });
+
+	filesystem::current_path(originalDirectory);
+	filesystem::remove_all(workDirectory);
+	return 0;
+}
@@ -0,0 +1,126 @@
+#include "ReadyQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Multi-producer/multi-consumer stress test for ReadyQueue.
+// Producers push tagged items (producer id in the high bits, a per-producer
+// counter in the low bits), mixing single and batch pushes through a small
+// queue so it is constantly full, empty and wrapping. Consumers pop with
+// single and batch pops. Afterwards every item must have arrived exactly
+// once, and each consumer must have seen every producer's items in order.
+//
+//   readyqueue_stress [producers] [consumers] [items per producer]
+
+namespace {
+
+constexpr size_t queueCapacity = 64;
+constexpr size_t maxBatch = 16;
+
+uint64_t makeItem(uint64_t producer, uint64_t sequence) {
+	return (producer << 32) | sequence;
+}
+
+void produce(ReadyQueue<uint64_t>& queue, uint64_t producer, uint64_t items) {
+	uint64_t batch[maxBatch];
+	uint64_t next = 0;
+	while (next < items) {
+		// Alternate single pushes with batches of varying size
+		size_t count = static_cast<size_t>(next % (maxBatch + 1));
+		if (count <= 1) {
+			queue.push(makeItem(producer, next++));
+			continue;
+		}
+		count = static_cast<size_t>(min<uint64_t>(count, items - next));
+		for (size_t i = 0; i < count; i++) {
+			batch[i] = makeItem(producer, next + i);
+		}
+		queue.pushBatch(batch, count);
+		next += count;
+	}
+}
+
+// Returns false on the first out-of-order item
+bool consume(ReadyQueue<uint64_t>& queue, atomic<uint64_t>& remaining, vector<uint8_t>& seen, size_t producers,
+	uint64_t itemsPerProducer, int consumer) {
+	vector<int64_t> lastSequence(producers, -1);
+	uint64_t batch[maxBatch];
+	bool ordered = true;
+	size_t round = 0;
+	while (remaining.load(memory_order_relaxed) > 0) {
+		size_t count = round++ % 2 == 0 ? queue.tryPopBatch(batch, maxBatch) : queue.tryPop(batch[0]) ? 1 : 0;
+		if (count == 0) {
+			this_thread::yield();
+			continue;
+		}
+		remaining.fetch_sub(count, memory_order_relaxed);
+		for (size_t i = 0; i < count; i++) {
+			uint64_t producer = batch[i] >> 32;
+			int64_t sequence = static_cast<int64_t>(batch[i] & 0xFFFFFFFF);
+			if (producer >= producers || static_cast<uint64_t>(sequence) >= itemsPerProducer) {
+				cerr << "consumer " << consumer << ": corrupt item " << batch[i] << endl;
+				ordered = false;
+				continue;
+			}
+			// Each item has its own slot, so these counters are written by one consumer only
+			seen[producer * itemsPerProducer + sequence]++;
+			if (sequence <= lastSequence[producer]) {
+				cerr << "consumer " << consumer << ": producer " << producer << " item " << sequence
+					<< " arrived after item " << lastSequence[producer] << endl;
+				ordered = false;
+			}
+			lastSequence[producer] = sequence;
+		}
+	}
+	return ordered;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	size_t producers = argc > 1 ? stoul(argv[1]) : 8;
+	size_t consumers = argc > 2 ? stoul(argv[2]) : 4;
+	uint64_t itemsPerProducer = argc > 3 ? stoull(argv[3]) : 200000;
+
+	ReadyQueue<uint64_t> queue(queueCapacity);
+	vector<uint8_t> seen(producers * itemsPerProducer, 0);
+	atomic<uint64_t> remaining{ producers * itemsPerProducer };
+	atomic<bool> ordered{ true };
+
+	vector<thread> threads;
+	for (size_t c = 0; c < consumers; c++) {
+		threads.emplace_back([&, c] {
+			if (!consume(queue, remaining, seen, producers, itemsPerProducer, static_cast<int>(c))) {
+				ordered = false;
+			}
+		});
+	}
+	for (size_t p = 0; p < producers; p++) {
+		threads.emplace_back(produce, ref(queue), static_cast<uint64_t>(p), itemsPerProducer);
+	}
+	for (thread& t : threads) {
+		t.join();
+	}
+
+	size_t missing = 0, duplicated = 0;
+	for (uint8_t count : seen) {
+		missing += count == 0;
+		duplicated += count > 1;
+	}
+	uint64_t leftover;
+	bool drained = !queue.tryPop(leftover);
+
+	cout << producers << " producers, " << consumers << " consumers, " << seen.size() << " items: "
+		<< missing << " missing, " << duplicated << " duplicated" << (drained ? "" : ", queue not empty") << endl;
+	if (missing != 0 || duplicated != 0 || !drained || !ordered) {
+		cerr << "FAILED" << endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}